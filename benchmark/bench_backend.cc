@@ -0,0 +1,80 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// ============ AST 遍历 vs 闭包编译：同一脚本在两个后端上的耗时 ============
+
+struct Workload {
+  std::string name;
+  std::string source;
+};
+
+static std::vector<Workload> Workloads() {
+  std::vector<Workload> workloads;
+
+  workloads.push_back({"fib(25)", R"(
+fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+var result = fib(25);
+)"});
+
+  workloads.push_back({"循环算术 1M 次", R"(
+var sum = 0;
+for (var i = 0; i < 1000000; i = i + 1) {
+  sum = sum + i * 2 - i / 4;
+}
+)"});
+
+  workloads.push_back({"方法调用与字段读写 200K 次", R"(
+class Counter {
+  init() { this.count = 0; }
+  add(n) { this.count = this.count + n; return this; }
+}
+var counter = Counter();
+for (var i = 0; i < 200000; i = i + 1) {
+  counter.add(1);
+}
+)"});
+
+  workloads.push_back({"闭包计数器 300K 次", R"(
+fun makeCounter() {
+  var n = 0;
+  fun inc() { n = n + 1; return n; }
+  return inc;
+}
+var inc = makeCounter();
+for (var i = 0; i < 300000; i = i + 1) {
+  inc();
+}
+)"});
+
+  return workloads;
+}
+
+void benchBackend() {
+  std::cout << "\n🌲 执行后端对比（AST 遍历 vs 闭包编译）\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  for (auto& workload : Workloads()) {
+    double ast_ms = BestOf(
+        3, [&workload] { return RunSource(workload.source, Backend::AST); });
+    double closure_ms = BestOf(3, [&workload] {
+      return RunSource(workload.source, Backend::CLOSURE);
+    });
+
+    std::cout << workload.name << ":\n";
+    Report("AST 遍历", ast_ms);
+    std::ostringstream speedup;
+    speedup << std::fixed << std::setprecision(2) << ast_ms / closure_ms
+            << "x 快于 AST 遍历";
+    Report("闭包编译", closure_ms, speedup.str());
+  }
+}
+
+}  // namespace bench
+}  // namespace lox
@@ -0,0 +1,174 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// ============ 节点派发：按种类 switch vs Accept 虚调用 ============
+
+// 用户态硬件计数器（指令数、分支预测失败数）。
+// 只在 Linux 上通过 perf_event_open 实现；内核或容器不允许时 available()
+// 为 false，基准测试只报告耗时
+class HardwareCounters {
+ public:
+  HardwareCounters() {
+#ifdef __linux__
+    instructions_fd_ = Open(PERF_COUNT_HW_INSTRUCTIONS);
+    branch_misses_fd_ = Open(PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+  }
+
+  ~HardwareCounters() {
+#ifdef __linux__
+    if (instructions_fd_ >= 0) close(instructions_fd_);
+    if (branch_misses_fd_ >= 0) close(branch_misses_fd_);
+#endif
+  }
+
+  bool available() const {
+    return instructions_fd_ >= 0 && branch_misses_fd_ >= 0;
+  }
+
+  void Start() {
+#ifdef __linux__
+    for (int fd : {instructions_fd_, branch_misses_fd_}) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  void Stop() {
+#ifdef __linux__
+    for (int fd : {instructions_fd_, branch_misses_fd_}) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+  }
+
+  uint64_t instructions() const { return Read(instructions_fd_); }
+  uint64_t branch_misses() const { return Read(branch_misses_fd_); }
+
+ private:
+#ifdef __linux__
+  static int Open(uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+
+  static uint64_t Read(int fd) {
+    uint64_t value = 0;
+#ifdef __linux__
+    if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value)) {
+      value = 0;
+    }
+#endif
+    return value;
+  }
+
+  int instructions_fd_ = -1;
+  int branch_misses_fd_ = -1;
+};
+
+struct DispatchWorkload {
+  std::string name;
+  std::string source;
+};
+
+static std::vector<DispatchWorkload> DispatchWorkloads() {
+  std::vector<DispatchWorkload> workloads;
+
+  workloads.push_back({"fib(25)", R"(
+fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+var result = fib(25);
+)"});
+
+  workloads.push_back({"循环算术 1M 次", R"(
+var sum = 0;
+for (var i = 0; i < 1000000; i = i + 1) {
+  sum = sum + i * 2 - i / 4;
+}
+)"});
+
+  workloads.push_back({"方法调用与字段读写 200K 次", R"(
+class Counter {
+  init() { this.count = 0; }
+  add(n) { this.count = this.count + n; return this; }
+}
+var counter = Counter();
+for (var i = 0; i < 200000; i = i + 1) {
+  counter.add(1);
+}
+)"});
+
+  return workloads;
+}
+
+// 基准测试以 LOX_SELECTABLE_DISPATCH 编译，两种方式都带着同一次派发方式
+// 检查和节点计数，相对比较仍然公平；发布的解释器只有 switch，没有这些。
+// 耗时和计数器结果都按 Evaluate/Execute 实际派发的节点数折算，两种方式
+// 派发的节点完全相同
+void benchDispatch() {
+  std::cout << "\n🔀 节点派发对比（switch vs 虚调用）\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  HardwareCounters counters;
+  if (!counters.available()) {
+    std::cout << "（硬件计数器不可用，只报告耗时）\n";
+  }
+
+  const std::pair<Dispatch, const char*> modes[] = {
+      {Dispatch::VIRTUAL, "虚调用"},
+      {Dispatch::SWITCH, "switch"},
+  };
+  for (auto& workload : DispatchWorkloads()) {
+    uint64_t dispatched_nodes = 0;
+    RunSource(workload.source, Backend::AST, Dispatch::SWITCH,
+              &dispatched_nodes);
+    double nodes = static_cast<double>(dispatched_nodes);
+    std::cout << workload.name << "（" << dispatched_nodes << " 个节点）:\n";
+    for (auto& [dispatch, mode_name] : modes) {
+      double ms = BestOf(3, [&workload, dispatch = dispatch] {
+        return RunSource(workload.source, Backend::AST, dispatch);
+      });
+
+      std::ostringstream detail;
+      detail << std::fixed << std::setprecision(1)
+             << ms * 1e6 / nodes << " ns/node";
+      if (counters.available()) {
+        counters.Start();
+        RunSource(workload.source, Backend::AST, dispatch);
+        counters.Stop();
+        detail << ", " << counters.instructions() / nodes << " instr/node, "
+               << std::setprecision(3) << counters.branch_misses() / nodes
+               << " branch-miss/node";
+      }
+      Report(mode_name, ms, detail.str());
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace lox
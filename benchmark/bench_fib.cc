@@ -0,0 +1,98 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// ============ C++ 对照组：同样的递归，分别用普通返回和异常返回 ============
+
+static volatile int sink = 0;
+
+static long FibByReturn(int n) {
+  if (n < 2) return n + sink;
+  return FibByReturn(n - 1) + FibByReturn(n - 2);
+}
+
+struct FibResult {
+  long value;
+};
+
+// 模拟旧实现：每次函数返回都通过抛出异常传递返回值
+static void FibByThrow(int n) {
+  if (n < 2) throw FibResult{n + sink};
+  long left = 0;
+  long right = 0;
+  try {
+    FibByThrow(n - 1);
+  } catch (const FibResult& result) {
+    left = result.value;
+  }
+  try {
+    FibByThrow(n - 2);
+  } catch (const FibResult& result) {
+    right = result.value;
+  }
+  throw FibResult{left + right};
+}
+
+static std::string FibSource(int n) {
+  std::ostringstream source;
+  source << "fun fib(n) { if (n < 2) return n; "
+            "return fib(n - 1) + fib(n - 2); }\n"
+         << "var result = fib(" << n << ");\n";
+  return source.str();
+}
+
+// fib(n) 的调用次数：calls(n) = 2 * fib(n + 1) - 1
+static double FibCalls(int n) {
+  double a = 0;
+  double b = 1;
+  for (int i = 0; i < n + 1; ++i) {
+    double next = a + b;
+    a = b;
+    b = next;
+  }
+  return 2 * a - 1;
+}
+
+void benchFib() {
+  std::cout << "\n🐇 递归 fib 基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  std::cout << "Lox 解释器（return 通过 Completion 返回值传递）:\n";
+  for (int n : {20, 25, 27}) {
+    double ms = BestOf(3, [n] { return RunSource(FibSource(n)); });
+    std::ostringstream detail;
+    detail << std::fixed << std::setprecision(2)
+           << FibCalls(n) / ms / 1000.0 << " M calls/s";
+    Report("fib(" + std::to_string(n) + ")", ms, detail.str());
+  }
+
+  const int native_n = 25;
+  std::cout << "\nC++ 对照组 fib(" << native_n << "):\n";
+  double return_ms = BestOf(3, [] {
+    Stopwatch stopwatch;
+    sink = static_cast<int>(FibByReturn(native_n)) & 0;
+    return stopwatch.ElapsedMs();
+  });
+  double throw_ms = BestOf(3, [] {
+    Stopwatch stopwatch;
+    try {
+      FibByThrow(native_n);
+    } catch (const FibResult& result) {
+      sink = static_cast<int>(result.value) & 0;
+    }
+    return stopwatch.ElapsedMs();
+  });
+  Report("普通 return", return_ms);
+  std::ostringstream ratio;
+  ratio << std::fixed << std::setprecision(1) << throw_ms / return_ms
+        << "x 慢于普通 return";
+  Report("throw 传递返回值", throw_ms, ratio.str());
+}
+
+}  // namespace bench
+}  // namespace lox
@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "benchmark/bench_util.h"
+#include "lox_interpreter/core/source.h"
+
+namespace lox {
+namespace bench {
+
+// 写一个约 megabytes MB 的脚本文件，内容是重复的普通代码
+static std::string WriteScript(size_t megabytes) {
+  std::string block;
+  for (int i = 0; i < 64; ++i) {
+    block += "fun area" + std::to_string(i) +
+             "(width, height) {\n"
+             "  // rectangle area, rounded down to whole units\n"
+             "  var result = width * height;\n"
+             "  if (result > 100) { print \"large\"; }\n"
+             "  return result;\n"
+             "}\n";
+  }
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("lox_bench_load_" + std::to_string(megabytes) + ".lox"))
+                         .string();
+  std::ofstream file(path, std::ios::binary);
+  for (size_t written = 0; written < megabytes * 1024 * 1024;
+       written += block.size()) {
+    file << block;
+  }
+  return path;
+}
+
+// 扫描全部 token，相当于解析之前的启动开销
+static void ScanAll(std::string_view text) {
+  Scanner scanner(text);
+  while (scanner.NextToken().type() != TokenType::EEOF) {
+  }
+}
+
+static bool IsMapped(const std::string& path) {
+  Source source;
+  return Source::Load(path, &source) && source.mapped();
+}
+
+// 原来的读法：istreambuf_iterator 逐字节读进 std::string
+static double LoadWithStream(const std::string& path, bool scan) {
+  Stopwatch stopwatch;
+  std::ifstream file(path);
+  std::string content((std::istreambuf_iterator<char>(file)),
+                      std::istreambuf_iterator<char>());
+  if (scan) {
+    ScanAll(content);
+  }
+  return stopwatch.ElapsedMs();
+}
+
+static double LoadWithSource(const std::string& path, bool scan) {
+  Stopwatch stopwatch;
+  Source source;
+  Source::Load(path, &source);
+  if (scan) {
+    ScanAll(source.text());
+  }
+  return stopwatch.ElapsedMs();
+}
+
+void benchLoad() {
+  std::cout << "\n📂 源码加载基准测试（文件已在页缓存中）\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  for (size_t megabytes : {1, 10, 100}) {
+    std::string path = WriteScript(megabytes);
+    std::cout << megabytes << " MB 脚本:\n";
+
+    double stream = BestOf(3, [&] { return LoadWithStream(path, false); });
+    double source = BestOf(3, [&] { return LoadWithSource(path, false); });
+    Report("读入（istreambuf_iterator）", stream);
+    std::ostringstream speedup;
+    speedup << std::fixed << std::setprecision(1) << stream / source << "x";
+    Report(std::string("读入（Source::Load") +
+               (IsMapped(path) ? "，mmap）" : "）"),
+           source, speedup.str());
+
+    double stream_scan = BestOf(3, [&] { return LoadWithStream(path, true); });
+    double source_scan = BestOf(3, [&] { return LoadWithSource(path, true); });
+    Report("读入 + 扫描（istreambuf_iterator）", stream_scan);
+    std::ostringstream scan_speedup;
+    scan_speedup << std::fixed << std::setprecision(1)
+                 << stream_scan / source_scan << "x";
+    Report("读入 + 扫描（Source::Load）", source_scan, scan_speedup.str());
+
+    std::remove(path.c_str());
+  }
+}
+
+}  // namespace bench
+}  // namespace lox
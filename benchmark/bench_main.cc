@@ -0,0 +1,152 @@
+#include <iostream>
+#include <string>
+
+// 前向声明基准测试函数
+namespace lox {
+namespace bench {
+void benchFib();
+void benchObjects();
+void benchParse();
+void benchBackend();
+void benchDispatch();
+void benchRefcount();
+void benchStrings();
+void benchPrint();
+void benchScan();
+void benchLoad();
+}  // namespace bench
+}  // namespace lox
+
+void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [选项]\n\n";
+    std::cout << "选项:\n";
+    std::cout << "  --all           运行所有基准测试\n";
+    std::cout << "  --fib           递归 fib（函数调用与 return）\n";
+    std::cout << "  --objects       创建对象与字段读写\n";
+    std::cout << "  --parse         多 MB 生成脚本的解析与执行\n";
+    std::cout << "  --backend       AST 遍历与闭包编译两个执行后端对比\n";
+    std::cout << "  --dispatch      节点 switch 派发与虚调用派发对比\n";
+    std::cout << "  --refcount      值拷贝的引用计数开销与方法调用密集的脚本\n";
+    std::cout << "  --strings       字符串拼接与比较\n";
+    std::cout << "  --print         print 语句的输出吞吐\n";
+    std::cout << "  --scan          扫描器吞吐（MB/s）\n";
+    std::cout << "  --load          1/10/100 MB 源码文件的加载与扫描\n";
+    std::cout << "  --help, -h      显示帮助信息\n";
+    std::cout << "\n示例:\n";
+    std::cout << "  " << program << " --all\n";
+    std::cout << "  " << program << " --fib\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        std::cout << "❌ 错误: 需要指定基准测试选项\n\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool runAll = false;
+    bool runFib = false;
+    bool runObjects = false;
+    bool runParse = false;
+    bool runBackend = false;
+    bool runDispatch = false;
+    bool runRefcount = false;
+    bool runStrings = false;
+    bool runPrint = false;
+    bool runScan = false;
+    bool runLoad = false;
+
+    // 解析命令行参数
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--all") {
+            runAll = true;
+        } else if (arg == "--fib") {
+            runFib = true;
+        } else if (arg == "--objects") {
+            runObjects = true;
+        } else if (arg == "--parse") {
+            runParse = true;
+        } else if (arg == "--backend") {
+            runBackend = true;
+        } else if (arg == "--dispatch") {
+            runDispatch = true;
+        } else if (arg == "--refcount") {
+            runRefcount = true;
+        } else if (arg == "--strings") {
+            runStrings = true;
+        } else if (arg == "--print") {
+            runPrint = true;
+        } else if (arg == "--scan") {
+            runScan = true;
+        } else if (arg == "--load") {
+            runLoad = true;
+        } else {
+            std::cout << "❌ 未知选项: " << arg << "\n\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (runAll) {
+        runFib = true;
+        runObjects = true;
+        runParse = true;
+        runBackend = true;
+        runDispatch = true;
+        runRefcount = true;
+        runStrings = true;
+        runPrint = true;
+        runScan = true;
+        runLoad = true;
+    }
+
+    std::cout << "⏱️  Lox 基准测试\n";
+    std::cout << "===============\n";
+
+    if (runFib) {
+        lox::bench::benchFib();
+    }
+
+    if (runObjects) {
+        lox::bench::benchObjects();
+    }
+
+    if (runParse) {
+        lox::bench::benchParse();
+    }
+
+    if (runBackend) {
+        lox::bench::benchBackend();
+    }
+
+    if (runDispatch) {
+        lox::bench::benchDispatch();
+    }
+
+    if (runRefcount) {
+        lox::bench::benchRefcount();
+    }
+
+    if (runStrings) {
+        lox::bench::benchStrings();
+    }
+
+    if (runPrint) {
+        lox::bench::benchPrint();
+    }
+
+    if (runScan) {
+        lox::bench::benchScan();
+    }
+
+    if (runLoad) {
+        lox::bench::benchLoad();
+    }
+
+    return 0;
+}
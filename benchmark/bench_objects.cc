@@ -0,0 +1,109 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// 创建大量只有几个字段的小对象，并反复读写字段
+static std::string AllocateSource(int count) {
+  std::ostringstream source;
+  source << "class Point {\n"
+            "  init(x, y) { this.x = x; this.y = y; this.tag = 0; }\n"
+            "}\n"
+            "var sum = 0;\n"
+         << "for (var i = 0; i < " << count << "; i = i + 1) {\n"
+         << "  var p = Point(i, i + 1);\n"
+            "  p.tag = p.x + p.y;\n"
+            "  sum = sum + p.tag;\n"
+            "}\n";
+  return source.str();
+}
+
+// 少量对象上的字段读写，主要衡量单次属性访问的开销
+static std::string FieldAccessSource(int iterations) {
+  std::ostringstream source;
+  source << "class Counter { init() { this.a = 0; this.b = 0; this.c = 0; } }\n"
+            "var c = Counter();\n"
+         << "for (var i = 0; i < " << iterations << "; i = i + 1) {\n"
+         << "  c.a = c.a + 1;\n"
+            "  c.b = c.b + c.a;\n"
+            "  c.c = c.c + c.b;\n"
+            "}\n";
+  return source.str();
+}
+
+// 在多层继承的对象上反复调用定义在最顶层父类里的方法
+static std::string InheritedCallSource(int iterations) {
+  std::ostringstream source;
+  source << "class A { m() { return 1; } }\n"
+            "class B < A {}\n"
+            "class C < B {}\n"
+            "class D < C {}\n"
+            "var d = D();\n"
+            "var sum = 0;\n"
+         << "for (var i = 0; i < " << iterations << "; i = i + 1) {\n"
+         << "  sum = sum + d.m();\n"
+            "}\n";
+  return source.str();
+}
+
+// 六层继承：构造时查找继承来的 init，再调用父类方法
+static std::string DeepHierarchySource(int count) {
+  std::ostringstream source;
+  source << "class A { init(x) { this.x = x; } get() { return this.x; } }\n"
+            "class B < A {}\n"
+            "class C < B {}\n"
+            "class D < C {}\n"
+            "class E < D {}\n"
+            "class F < E {}\n"
+            "var sum = 0;\n"
+         << "for (var i = 0; i < " << count << "; i = i + 1) {\n"
+         << "  sum = sum + F(i).get();\n"
+            "}\n";
+  return source.str();
+}
+
+void benchObjects() {
+  std::cout << "\n📦 对象与字段访问基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  for (int count : {100000, 1000000}) {
+    double ms = BestOf(3, [count] { return RunSource(AllocateSource(count)); });
+    std::ostringstream detail;
+    detail << std::fixed << std::setprecision(2) << count / ms / 1000.0
+           << " M objects/s";
+    Report("创建 " + std::to_string(count) + " 个对象", ms, detail.str());
+  }
+
+  const int iterations = 1000000;
+  double ms =
+      BestOf(3, [] { return RunSource(FieldAccessSource(iterations)); });
+  // 每次循环 6 次读、3 次写
+  std::ostringstream detail;
+  detail << std::fixed << std::setprecision(2)
+         << iterations * 9.0 / ms / 1000.0 << " M accesses/s";
+  Report("字段读写 " + std::to_string(iterations) + " 轮", ms, detail.str());
+
+  double call_ms =
+      BestOf(3, [] { return RunSource(InheritedCallSource(iterations)); });
+  std::ostringstream call_detail;
+  call_detail << std::fixed << std::setprecision(2)
+              << iterations / call_ms / 1000.0 << " M calls/s";
+  Report("继承方法调用 " + std::to_string(iterations) + " 次", call_ms,
+         call_detail.str());
+
+  const int deep_count = 300000;
+  double deep_ms =
+      BestOf(3, [] { return RunSource(DeepHierarchySource(deep_count)); });
+  std::ostringstream deep_detail;
+  deep_detail << std::fixed << std::setprecision(2)
+              << deep_count / deep_ms / 1000.0 << " M objects/s";
+  Report("六层继承构造 " + std::to_string(deep_count) + " 次", deep_ms,
+         deep_detail.str());
+}
+
+}  // namespace bench
+}  // namespace lox
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// 生成约 target_bytes 字节的脚本：大量小函数、分支、循环和类，
+// 每个函数只调用一次，耗时主要花在扫描、解析和语法树的构建/销毁上
+static std::string GenerateScript(size_t target_bytes) {
+  std::ostringstream source;
+  int i = 0;
+  while (static_cast<size_t>(source.tellp()) < target_bytes) {
+    source << "fun f" << i << "(a, b) {\n"
+           << "  var x = a * 2 + b - (a / 4);\n"
+           << "  if (x > 10 and b != nil) { x = x - 1; } else { x = x + 1; }\n"
+           << "  for (var j = 0; j < 2; j = j + 1) { x = x + j; }\n"
+           << "  return x;\n"
+           << "}\n"
+           << "class C" << i << " { init(v) { this.v = v; } get() { return "
+           << "this.v; } }\n"
+           << "var v" << i << " = f" << i << "(" << i << ", 3) + C" << i
+           << "(1).get();\n";
+    ++i;
+  }
+  return source.str();
+}
+
+struct PhaseTimes {
+  // 扫描和解析交替进行，计在一起
+  double parse = 0;
+  double resolve = 0;
+  double interpret = 0;
+  double teardown = 0;
+  size_t arena_bytes = 0;
+  size_t arena_blocks = 0;
+
+  double total() const { return parse + resolve + interpret + teardown; }
+};
+
+static PhaseTimes RunPhases(const std::string& source) {
+  PhaseTimes times;
+  Stopwatch total;
+  {
+    auto arena = std::make_unique<AstArena>();
+    auto interpreter = std::make_unique<Interpreter>();
+
+    Stopwatch phase;
+    Scanner scanner(source);
+    Parser parser(scanner, *arena);
+    std::vector<StmtPtr> statements = parser.Parse();
+    times.parse = phase.ElapsedMs();
+    times.arena_bytes = arena->bytes_used();
+    times.arena_blocks = arena->block_count();
+
+    phase = Stopwatch();
+    Resolver resolver(*interpreter);
+    resolver.Resolve(statements);
+    times.resolve = phase.ElapsedMs();
+
+    phase = Stopwatch();
+    interpreter->Interpret(std::move(statements), std::move(arena));
+    times.interpret = phase.ElapsedMs();
+
+    // 语法树、arena 和运行时对象都随解释器一起销毁
+    phase = Stopwatch();
+    interpreter.reset();
+    times.teardown = phase.ElapsedMs();
+  }
+  Lox::Instance().ResetErrors();
+  return times;
+}
+
+void benchParse() {
+  std::cout << "\n🌲 大脚本解析与执行基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  for (size_t megabytes : {2, 8}) {
+    std::string source = GenerateScript(megabytes * 1024 * 1024);
+    PhaseTimes best;
+    best.parse = -1;
+    for (int run = 0; run < 3; ++run) {
+      PhaseTimes times = RunPhases(source);
+      if (best.parse < 0 || times.total() < best.total()) {
+        best = times;
+      }
+    }
+
+    double mb = source.size() / (1024.0 * 1024.0);
+    std::cout << megabytes << " MB 脚本:\n";
+    std::ostringstream parse_detail;
+    parse_detail << std::fixed << std::setprecision(2) << mb / best.parse * 1000
+                 << " MB/s, arena " << best.arena_bytes / (1024 * 1024)
+                 << " MB / " << best.arena_blocks << " 块";
+    Report("扫描 + 解析", best.parse, parse_detail.str());
+    Report("变量解析", best.resolve);
+    Report("执行", best.interpret);
+    Report("销毁", best.teardown);
+    std::ostringstream total_detail;
+    total_detail << std::fixed << std::setprecision(2)
+                 << mb / best.total() * 1000 << " MB/s";
+    Report("合计", best.total(), total_detail.str());
+  }
+}
+
+}  // namespace bench
+}  // namespace lox
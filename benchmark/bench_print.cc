@@ -0,0 +1,65 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// 报表脚本：每行打印一个拼好的字符串
+static std::string PrintStringsSource(int lines) {
+  std::ostringstream source;
+  source << "var label = \"total for region north-east: \";\n"
+         << "for (var i = 0; i < " << lines << "; i = i + 1) {\n"
+         << "  print label;\n"
+            "}\n";
+  return source.str();
+}
+
+// 整数和小数交替打印，小数走最短往返格式化
+static std::string PrintNumbersSource(int lines) {
+  std::ostringstream source;
+  source << "for (var i = 0; i < " << lines / 2 << "; i = i + 1) {\n"
+         << "  print i;\n"
+            "  print i / 7;\n"
+            "}\n";
+  return source.str();
+}
+
+// 标准输出重定向到 /dev/null 运行，只计格式化和写出的开销
+static double RunToDevNull(const std::string& source) {
+  std::filebuf null_output;
+  null_output.open("/dev/null", std::ios::out);
+  std::streambuf* original = std::cout.rdbuf(&null_output);
+  double ms = RunSource(source);
+  std::cout.rdbuf(original);
+  return ms;
+}
+
+void benchPrint() {
+  std::cout << "\n🖨️  输出吞吐基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  const int lines = 1000000;
+  double strings_ms =
+      BestOf(3, [] { return RunToDevNull(PrintStringsSource(lines)); });
+  std::ostringstream strings_detail;
+  strings_detail << std::fixed << std::setprecision(2)
+                 << lines / strings_ms / 1000.0 << " M lines/s";
+  Report("打印字符串 " + std::to_string(lines) + " 行", strings_ms,
+         strings_detail.str());
+
+  double numbers_ms =
+      BestOf(3, [] { return RunToDevNull(PrintNumbersSource(lines)); });
+  std::ostringstream numbers_detail;
+  numbers_detail << std::fixed << std::setprecision(2)
+                 << lines / numbers_ms / 1000.0 << " M lines/s";
+  Report("打印整数与小数 " + std::to_string(lines) + " 行", numbers_ms,
+         numbers_detail.str());
+}
+
+}  // namespace bench
+}  // namespace lox
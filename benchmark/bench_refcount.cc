@@ -0,0 +1,132 @@
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/bench_util.h"
+#include "lox_interpreter/util/lox_class.h"
+#include "lox_interpreter/util/lox_instance.h"
+
+namespace lox {
+namespace bench {
+
+// 在一小组槽位之间来回拷贝，每次拷贝赋值都是一次加计数和一次减计数
+template <typename T>
+static double CopyLoop(const T& value, int iterations) {
+  std::vector<T> slots(64, value);
+  Stopwatch stopwatch;
+  for (int i = 0; i < iterations; i++) {
+    slots[i & 63] = slots[(i + 1) & 63];
+  }
+  return stopwatch.ElapsedMs();
+}
+
+// 向量运算：每次方法调用都把实例作为 this 和参数传来传去
+static std::string VectorMathSource(int iterations) {
+  std::ostringstream source;
+  source << "class Vec {\n"
+            "  init(x, y) { this.x = x; this.y = y; }\n"
+            "  dot(other) { return this.x * other.x + this.y * other.y; }\n"
+            "  scaled(k) { return Vec(this.x * k, this.y * k); }\n"
+            "}\n"
+            "var a = Vec(1, 2);\n"
+            "var b = Vec(3, 4);\n"
+            "var sum = 0;\n"
+         << "for (var i = 0; i < " << iterations << "; i = i + 1) {\n"
+         << "  sum = sum + a.dot(b) + a.scaled(2).dot(a);\n"
+            "}\n";
+  return source.str();
+}
+
+// 沿链表逐个节点调用方法，每一步都读出并传递对象引用
+static std::string ListWalkSource(int length, int rounds) {
+  std::ostringstream source;
+  source << "class Node {\n"
+            "  init(value, next) { this.value = value; this.next = next; }\n"
+            "  getNext() { return this.next; }\n"
+            "  getValue() { return this.value; }\n"
+            "}\n"
+            "var head = nil;\n"
+         << "for (var i = 0; i < " << length << "; i = i + 1) {\n"
+         << "  head = Node(i, head);\n"
+            "}\n"
+            "var sum = 0;\n"
+         << "for (var r = 0; r < " << rounds << "; r = r + 1) {\n"
+         << "  var node = head;\n"
+            "  while (node != nil) {\n"
+            "    sum = sum + node.getValue();\n"
+            "    node = node.getNext();\n"
+            "  }\n"
+            "}\n";
+  return source.str();
+}
+
+// 取出绑定方法存在变量里反复调用
+static std::string BoundMethodSource(int iterations) {
+  std::ostringstream source;
+  source << "class Counter {\n"
+            "  init() { this.n = 0; }\n"
+            "  inc() { this.n = this.n + 1; return this; }\n"
+            "}\n"
+            "var c = Counter();\n"
+            "var inc = c.inc;\n"
+         << "for (var i = 0; i < " << iterations << "; i = i + 1) {\n"
+         << "  inc().inc();\n"
+            "}\n";
+  return source.str();
+}
+
+void benchRefcount() {
+  std::cout << "\n🔢 引用计数基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  // LoxObject 的侵入式非原子计数与 std::shared_ptr 的原子计数对比
+  const int copies = 50000000;
+  Ref<LoxClass> klass = MakeRef<LoxClass>("Point");
+  LoxObject instance(MakeRef<LoxInstance>(klass));
+  double object_ms = BestOf(3, [&] { return CopyLoop(instance, copies); });
+  auto shared = std::make_shared<int>(0);
+  double shared_ms = BestOf(3, [&] { return CopyLoop(shared, copies); });
+  std::ostringstream object_detail;
+  object_detail << std::fixed << std::setprecision(2)
+                << object_ms * 1e6 / copies << " ns/copy";
+  Report("LoxObject 拷贝（实例）", object_ms, object_detail.str());
+  std::ostringstream shared_detail;
+  shared_detail << std::fixed << std::setprecision(2)
+                << shared_ms * 1e6 / copies << " ns/copy";
+  Report("std::shared_ptr 拷贝（对照）", shared_ms, shared_detail.str());
+
+  const int iterations = 300000;
+  double vec_ms =
+      BestOf(3, [] { return RunSource(VectorMathSource(iterations)); });
+  // 每轮 3 次方法调用加 1 次构造
+  std::ostringstream vec_detail;
+  vec_detail << std::fixed << std::setprecision(2)
+             << iterations * 4.0 / vec_ms / 1000.0 << " M calls/s";
+  Report("向量方法调用 " + std::to_string(iterations) + " 轮", vec_ms,
+         vec_detail.str());
+
+  const int length = 1000;
+  const int rounds = 300;
+  double list_ms =
+      BestOf(3, [] { return RunSource(ListWalkSource(length, rounds)); });
+  std::ostringstream list_detail;
+  list_detail << std::fixed << std::setprecision(2)
+              << length * rounds * 2.0 / list_ms / 1000.0 << " M calls/s";
+  Report("链表遍历 " + std::to_string(length) + " x " +
+             std::to_string(rounds),
+         list_ms, list_detail.str());
+
+  double bound_ms =
+      BestOf(3, [] { return RunSource(BoundMethodSource(iterations)); });
+  std::ostringstream bound_detail;
+  bound_detail << std::fixed << std::setprecision(2)
+               << iterations * 2.0 / bound_ms / 1000.0 << " M calls/s";
+  Report("绑定方法调用 " + std::to_string(iterations) + " 轮", bound_ms,
+         bound_detail.str());
+}
+
+}  // namespace bench
+}  // namespace lox
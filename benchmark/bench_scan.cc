@@ -0,0 +1,104 @@
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// 紧凑的代码：短标识符、运算符和数字，几乎没有空白
+static std::string DenseSource(size_t target_bytes) {
+  std::ostringstream source;
+  for (int i = 0; static_cast<size_t>(source.tellp()) < target_bytes; i++) {
+    source << "var v" << i % 64 << "=a*2+b-(c/4);if(v" << i % 64
+           << ">10 and b!=nil){x=x-1;}else{x=x+1;}\n";
+  }
+  return source.str();
+}
+
+// 手写风格的代码：缩进、较长的名字、文档注释和行尾注释
+static std::string IndentedSource(size_t target_bytes) {
+  std::ostringstream source;
+  for (int i = 0; static_cast<size_t>(source.tellp()) < target_bytes; i++) {
+    source << "/*\n"
+              " * Computes the running total for the current reporting\n"
+              " * period. Values outside the configured window are skipped.\n"
+              " */\n"
+              "class ReportAccumulator" << i % 64 << " {\n"
+              "    accumulateRunningTotal(currentValue, windowLength) {\n"
+              "        // Skip values that fall outside the window\n"
+              "        if (currentValue > windowLength) {\n"
+              "            return this.previousRunningTotal;\n"
+              "        }\n"
+              "\n"
+              "        return this.previousRunningTotal + currentValue;\n"
+              "    }\n"
+              "}\n\n";
+  }
+  return source.str();
+}
+
+// 以长字符串字面量为主（模板、文本数据）
+static std::string StringSource(size_t target_bytes) {
+  std::ostringstream source;
+  for (int i = 0; static_cast<size_t>(source.tellp()) < target_bytes; i++) {
+    source << "print \"<tr><td class='name'>Northern region quarterly "
+              "summary</td><td class='value'>\" + total" << i % 64 << ";\n"
+              "var note" << i % 64 << " = \"Figures are preliminary and\n"
+              "may be revised once the audit for this period completes.\";\n";
+  }
+  return source.str();
+}
+
+// 同一份源码反复扫描，单个文件保持常见的大小，token 数组不会大到
+// 让缺页开销盖过扫描本身
+static double ScanRepeatedly(const std::string& source, int repeats,
+                             size_t* tokens) {
+  Stopwatch stopwatch;
+  for (int i = 0; i < repeats; ++i) {
+    Scanner scanner(source);
+    *tokens = scanner.ScanTokens().size();
+  }
+  return stopwatch.ElapsedMs();
+}
+
+void benchScan() {
+  std::cout << "\n🔎 扫描吞吐基准测试";
+#if defined(__AVX2__)
+  std::cout << "（AVX2）\n";
+#elif defined(__SSE2__)
+  std::cout << "（SSE2）\n";
+#else
+  std::cout << "（标量）\n";
+#endif
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  const size_t bytes = 1024 * 1024;
+  const int repeats = 16;
+  struct Input {
+    const char* name;
+    std::string source;
+  };
+  std::vector<Input> inputs;
+  inputs.push_back({"紧凑代码", DenseSource(bytes)});
+  inputs.push_back({"缩进与注释", IndentedSource(bytes)});
+  inputs.push_back({"长字符串", StringSource(bytes)});
+
+  for (const Input& input : inputs) {
+    size_t tokens = 0;
+    double ms = BestOf(
+        3, [&] { return ScanRepeatedly(input.source, repeats, &tokens); });
+    double mb = repeats * input.source.size() / (1024.0 * 1024.0);
+    std::ostringstream detail;
+    detail << std::fixed << std::setprecision(1) << mb / ms * 1000
+           << " MB/s, " << tokens << " 个 token";
+    Report(std::string(input.name) + " 1 MB × " + std::to_string(repeats),
+           ms, detail.str());
+  }
+}
+
+}  // namespace bench
+}  // namespace lox
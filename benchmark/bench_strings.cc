@@ -0,0 +1,67 @@
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/bench_util.h"
+
+namespace lox {
+namespace bench {
+
+// 模板渲染：字符串在变量、参数和返回值之间传递，再拼接成一行输出
+static std::string TemplateSource(int rows) {
+  std::ostringstream source;
+  source << "fun tag(name, body) {\n"
+            "  return \"<\" + name + \">\" + body + \"</\" + name + \">\";\n"
+            "}\n"
+            "var title = \"Quarterly report for the northern region\";\n"
+            "var cls = \"row-highlighted\";\n"
+            "var total = 0;\n"
+         << "for (var i = 0; i < " << rows << "; i = i + 1) {\n"
+         << "  var cell = tag(\"td\", title);\n"
+            "  var row = tag(\"tr\", cell + tag(\"td\", cls));\n"
+            "  if (row != cell) total = total + 1;\n"
+            "}\n";
+  return source.str();
+}
+
+// 按字符串键分派：长度相同、前缀相同的键，比较结果由缓存的哈希决定
+static std::string KeyDispatchSource(int iterations) {
+  std::ostringstream source;
+  source << "var keys = \"event:user:login:success\";\n"
+            "var other = \"event:user:login:failure\";\n"
+            "var hits = 0;\n"
+         << "for (var i = 0; i < " << iterations << "; i = i + 1) {\n"
+         << "  if (keys == \"event:user:login:failure\") hits = hits + 1;\n"
+            "  if (other == \"event:user:login:success\") hits = hits + 1;\n"
+            "  if (keys == other) hits = hits + 1;\n"
+            "}\n";
+  return source.str();
+}
+
+void benchStrings() {
+  std::cout << "\n🔤 字符串基准测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+  const int rows = 200000;
+  double template_ms =
+      BestOf(3, [] { return RunSource(TemplateSource(rows)); });
+  // 每行 3 次 tag 调用，每次 6 次拼接，外加 1 次拼接
+  std::ostringstream template_detail;
+  template_detail << std::fixed << std::setprecision(2)
+                  << rows * 19.0 / template_ms / 1000.0 << " M concats/s";
+  Report("模板渲染 " + std::to_string(rows) + " 行", template_ms,
+         template_detail.str());
+
+  const int iterations = 1000000;
+  double compare_ms =
+      BestOf(3, [] { return RunSource(KeyDispatchSource(iterations)); });
+  std::ostringstream compare_detail;
+  compare_detail << std::fixed << std::setprecision(2)
+                 << iterations * 3.0 / compare_ms / 1000.0 << " M compares/s";
+  Report("字符串键比较 " + std::to_string(iterations) + " 轮", compare_ms,
+         compare_detail.str());
+}
+
+}  // namespace bench
+}  // namespace lox
@@ -0,0 +1,87 @@
+#ifndef LOX_BENCHMARK_BENCH_UTIL_H_
+#define LOX_BENCHMARK_BENCH_UTIL_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "lox_interpreter/core/scanner.h"
+#include "lox_interpreter/core/parser.h"
+#include "lox_interpreter/core/resolver.h"
+#include "lox_interpreter/core/lox.h"
+#include "lox_interpreter/ast/visitors/interpreter.h"
+
+namespace lox {
+namespace bench {
+
+class Stopwatch {
+ public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  double ElapsedMs() const {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+// 完整运行一段 Lox 源码（扫描 → 解析 → 变量解析 → 执行），返回耗时（毫秒）。
+// dispatched_nodes 非空时写入执行期间派发过的 AST 节点数
+inline double RunSource(const std::string& source,
+                        Backend backend = Backend::AST,
+                        Dispatch dispatch = Dispatch::SWITCH,
+                        uint64_t* dispatched_nodes = nullptr) {
+  Stopwatch stopwatch;
+  Scanner scanner(source);
+  AstArena arena;
+  Parser parser(scanner, arena);
+  std::vector<StmtPtr> statements = parser.Parse();
+  if (!Lox::Instance().HadError()) {
+    Interpreter interpreter;
+    interpreter.set_backend(backend);
+    interpreter.set_dispatch(dispatch);
+    Resolver resolver(interpreter);
+    resolver.Resolve(statements);
+    if (!Lox::Instance().HadError()) {
+      interpreter.Interpret(std::move(statements));
+    }
+    if (dispatched_nodes != nullptr) {
+      *dispatched_nodes = interpreter.dispatched_nodes();
+    }
+  }
+  Lox::Instance().ResetErrors();
+  return stopwatch.ElapsedMs();
+}
+
+// 重复运行若干次，取最短耗时，减少噪声
+template <typename Fn>
+double BestOf(int runs, Fn&& fn) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < runs; ++i) {
+    best = std::min(best, fn());
+  }
+  return best;
+}
+
+inline void Report(const std::string& name, double ms,
+                   const std::string& detail = "") {
+  std::cout << "  " << std::left << std::setw(36) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2) << ms
+            << " ms";
+  if (!detail.empty()) {
+    std::cout << "   " << detail;
+  }
+  std::cout << "\n";
+}
+
+}  // namespace bench
+}  // namespace lox
+
+#endif  // LOX_BENCHMARK_BENCH_UTIL_H_
@@ -0,0 +1,98 @@
+#ifndef LOX_AST_ARENA_H_
+#define LOX_AST_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "lox_interpreter/core/source.h"
+
+namespace lox {
+
+// AST 节点的删除器：只调用析构函数释放节点自己持有的资源（字符串、
+// 子节点数组等），节点本身占用的内存由 AstArena 统一回收
+struct NodeDeleter {
+  template <typename T>
+  void operator()(T* node) const {
+    node->~T();
+  }
+};
+
+template <typename T>
+using NodePtr = std::unique_ptr<T, NodeDeleter>;
+
+// 一次编译（一个文件或 REPL 中的一行）的所有 AST 节点都从同一个 arena
+// 分配：按指针递增切分大块内存，相邻解析出的节点在内存中也相邻；
+// 销毁时按块整体释放，不再逐个 delete。
+//
+// arena 必须比从它分配的所有节点活得更久。节点中的 token 引用源码，
+// 需要长期保存的语法树应通过 AdoptSource 把源码一并交给 arena。
+class AstArena {
+ public:
+  AstArena() = default;
+  AstArena(const AstArena&) = delete;
+  AstArena& operator=(const AstArena&) = delete;
+
+  ~AstArena() {
+    for (char* block : blocks_) {
+      ::operator delete(block);
+    }
+  }
+
+  template <typename T, typename... Args>
+  NodePtr<T> New(Args&&... args) {
+    void* memory = Allocate(sizeof(T), alignof(T));
+    return NodePtr<T>(new (memory) T(std::forward<Args>(args)...));
+  }
+
+  // 接管本次编译的源码，返回的 view 与 arena 同寿命，扫描时使用它
+  std::string_view AdoptSource(Source source) {
+    source_ = std::move(source);
+    return source_.text();
+  }
+
+  // 已分配出去的字节数（含对齐填充）
+  size_t bytes_used() const { return bytes_used_; }
+
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  // 块大小从 kMinBlockSize 开始翻倍，最大 kMaxBlockSize
+  static constexpr size_t kMinBlockSize = 16 * 1024;
+  static constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+  void* Allocate(size_t size, size_t alignment) {
+    size_t offset = (offset_ + alignment - 1) & ~(alignment - 1);
+    if (blocks_.empty() || offset + size > block_size_) {
+      NewBlock(size);
+      offset = 0;
+    }
+    bytes_used_ += offset + size - offset_;
+    offset_ = offset + size;
+    return blocks_.back() + offset;
+  }
+
+  void NewBlock(size_t min_size) {
+    size_t next = blocks_.empty() ? kMinBlockSize
+                                  : std::min(block_size_ * 2, kMaxBlockSize);
+    block_size_ = std::max(next, min_size);
+    // operator new 返回的内存满足 max_align_t 对齐，足够所有节点类型使用
+    blocks_.push_back(static_cast<char*>(::operator new(block_size_)));
+    offset_ = 0;
+  }
+
+  std::vector<char*> blocks_;
+  Source source_;
+  size_t block_size_ = 0;
+  size_t offset_ = 0;
+  size_t bytes_used_ = 0;
+};
+
+}  // namespace lox
+
+#endif  // LOX_AST_ARENA_H_
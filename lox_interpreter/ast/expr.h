@@ -1,28 +1,80 @@
 #ifndef LOX_AST_EXPR_H_
 #define LOX_AST_EXPR_H_
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "lox_interpreter/ast/arena.h"
 #include "lox_interpreter/ast/visitor.h"
 #include "lox_interpreter/core/token.h"
+#include "lox_interpreter/util/inline_cache.h"
 #include "lox_interpreter/util/lox_object.h"
 
 namespace lox {
 
+// 节点种类。Interpreter 按它 switch 派发，不经过 Accept 的虚调用；
+// Resolver、Printer 等其余访问者仍然使用 Accept
+enum class ExprKind : uint8_t {
+  BINARY,
+  UNARY,
+  LITERAL,
+  GROUPING,
+  VARIABLE,
+  ASSIGN,
+  LOGICAL,
+  CALL,
+  GET,
+  SET,
+  THIS,
+  SUPER,
+};
+
 class Expr {
  public:
+  explicit Expr(ExprKind kind) : kind_(kind) {}
   virtual ~Expr() = default;
   virtual LoxObject Accept(ExprVisitor& visitor) = 0;
+
+  ExprKind kind() const { return kind_; }
+
+ private:
+  ExprKind kind_;
+};
+
+using ExprPtr = NodePtr<Expr>;
+
+// Resolver 写在节点上的变量位置
+struct VariableRef {
+  enum class Kind : uint8_t {
+    GLOBAL,   // 全局变量表下标
+    LOCAL,    // 当前栈帧中的槽位
+    CELL,     // 当前栈帧中的槽位，变量被闭包捕获，值放在 Cell 里
+    UPVALUE,  // 当前闭包捕获的第 slot 个外层变量
+  };
+
+  Kind kind = Kind::GLOBAL;
+  int slot = -1;
 };
 
-using ExprPtr = std::unique_ptr<Expr>;
+// 运算节点根据实际见到的操作数类型改写自己的求值方式：
+// 第一次执行时按操作数类型选定特化版本，之后只检查一次类型守卫就走
+// 对应的快速路径；守卫失败则退化为通用版本，不再尝试特化
+enum class Specialization : uint8_t {
+  UNINITIALIZED,  // 尚未执行过
+  NUMBER,         // 数字与数字
+  STRING,         // 字符串与字符串（+、==、!=）
+  GENERIC,        // 通用版本
+};
 
 class BinaryExpr : public Expr {
  public:
   BinaryExpr(ExprPtr left, Token op, ExprPtr right)
-      : left_(std::move(left)), op_(std::move(op)), right_(std::move(right)) {}
+      : Expr(ExprKind::BINARY),
+        left_(std::move(left)),
+        op_(std::move(op)),
+        right_(std::move(right)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -31,12 +83,13 @@ class BinaryExpr : public Expr {
   ExprPtr left_;
   Token op_;
   ExprPtr right_;
+  Specialization specialization_ = Specialization::UNINITIALIZED;
 };
 
 class UnaryExpr : public Expr {
  public:
   UnaryExpr(Token op, ExprPtr right)
-      : op_(std::move(op)), right_(std::move(right)) {}
+      : Expr(ExprKind::UNARY), op_(std::move(op)), right_(std::move(right)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -44,11 +97,13 @@ class UnaryExpr : public Expr {
 
   Token op_;
   ExprPtr right_;
+  Specialization specialization_ = Specialization::UNINITIALIZED;
 };
 
 class LiteralExpr : public Expr {
  public:
-  explicit LiteralExpr(LoxObject value) : value_(std::move(value)) {}
+  explicit LiteralExpr(LoxObject value)
+      : Expr(ExprKind::LITERAL), value_(std::move(value)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -60,7 +115,7 @@ class LiteralExpr : public Expr {
 class GroupingExpr : public Expr {
  public:
   explicit GroupingExpr(ExprPtr expression)
-      : expression_(std::move(expression)) {}
+      : Expr(ExprKind::GROUPING), expression_(std::move(expression)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -71,19 +126,23 @@ class GroupingExpr : public Expr {
 
 class VariableExpr : public Expr {
  public:
-  VariableExpr(Token name) : name_(std::move(name)) {}
+  VariableExpr(Token name)
+      : Expr(ExprKind::VARIABLE), name_(std::move(name)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
   }
 
   Token name_;
+  VariableRef ref_;
 };
 
 class AssignExpr : public Expr {
  public:
   AssignExpr(Token name, ExprPtr value)
-      : name_(std::move(name)), value_(std::move(value)) {}
+      : Expr(ExprKind::ASSIGN),
+        name_(std::move(name)),
+        value_(std::move(value)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -91,12 +150,16 @@ class AssignExpr : public Expr {
 
   Token name_;
   ExprPtr value_;
+  VariableRef ref_;
 };
 
 class LogicalExpr : public Expr {
  public:
   LogicalExpr(ExprPtr left, Token op, ExprPtr right)
-      : left_(std::move(left)), op_(std::move(op)), right_(std::move(right)) {}
+      : Expr(ExprKind::LOGICAL),
+        left_(std::move(left)),
+        op_(std::move(op)),
+        right_(std::move(right)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -107,10 +170,13 @@ class LogicalExpr : public Expr {
   ExprPtr right_;
 };
 
+class GetExpr;
+
 class CallExpr : public Expr {
  public:
   CallExpr(ExprPtr callee, Token paren, std::vector<ExprPtr> arguments)
-      : callee_(std::move(callee)),
+      : Expr(ExprKind::CALL),
+        callee_(std::move(callee)),
         paren_(std::move(paren)),
         arguments_(std::move(arguments)) {}
 
@@ -121,12 +187,16 @@ class CallExpr : public Expr {
   ExprPtr callee_;
   Token paren_;
   std::vector<ExprPtr> arguments_;
+  // callee 是属性访问（obj.method）时指向它，解释器据此直接调用方法
+  GetExpr* method_ = nullptr;
 };
 
 class GetExpr : public Expr {
  public:
   GetExpr(ExprPtr object, Token name)
-      : object_(std::move(object)), name_(std::move(name)) {}
+      : Expr(ExprKind::GET),
+        object_(std::move(object)),
+        name_(std::move(name)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
@@ -134,12 +204,15 @@ class GetExpr : public Expr {
 
   ExprPtr object_;
   Token name_;
+  // 本访问点的内联缓存
+  PropertyCache cache_;
 };
 
 class SetExpr : public Expr {
  public:
   SetExpr(ExprPtr object, Token name, ExprPtr value)
-      : object_(std::move(object)),
+      : Expr(ExprKind::SET),
+        object_(std::move(object)),
         name_(std::move(name)),
         value_(std::move(value)) {}
 
@@ -150,28 +223,36 @@ class SetExpr : public Expr {
   ExprPtr object_;
   Token name_;
   ExprPtr value_;
+  // 本访问点的内联缓存
+  PropertyCache cache_;
 };
 
 class ThisExpr : public Expr {
  public:
-  ThisExpr(Token keyword) : keyword_(std::move(keyword)) {}
+  ThisExpr(Token keyword)
+      : Expr(ExprKind::THIS), keyword_(std::move(keyword)) {}
 
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
   }
 
   Token keyword_;
+  VariableRef ref_;
 };
 
 class SuperExpr : public Expr {
  public:
-  SuperExpr(Token keyword, Token method) : keyword_(keyword), method_(method) {}
+  SuperExpr(Token keyword, Token method)
+      : Expr(ExprKind::SUPER), keyword_(keyword), method_(method) {}
   LoxObject Accept(ExprVisitor& visitor) override {
     return visitor.Visit(*this);
   }
 
   Token keyword_;
   Token method_;
+  // super 所在的位置，以及当前方法的 this
+  VariableRef ref_;
+  VariableRef this_ref_;
 };
 }  // namespace lox
 
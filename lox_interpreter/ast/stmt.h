@@ -3,43 +3,75 @@
 
 #include "lox_interpreter/ast/expr.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace lox {
 
+// 语句种类，用途同 ExprKind
+enum class StmtKind : uint8_t {
+  BLOCK,
+  EXPRESSION,
+  PRINT,
+  VAR,
+  IF,
+  WHILE,
+  BREAK,
+  FUNCTION,
+  RETURN,
+  CLASS,
+};
+
 class Stmt {
  public:
+  explicit Stmt(StmtKind kind) : kind_(kind) {}
   virtual ~Stmt() = default;
-  virtual void Accept(StmtVisitor& visitor) = 0;
+  virtual Completion Accept(StmtVisitor& visitor) = 0;
+
+  StmtKind kind() const { return kind_; }
+
+ private:
+  StmtKind kind_;
 };
 
-using StmtPtr = std::unique_ptr<Stmt>;
+using StmtPtr = NodePtr<Stmt>;
+
+class Interpreter;
+
+// 闭包编译后端（ClosureCompiler）把语句编译成的可执行闭包
+using CompiledStmt = std::function<Completion(Interpreter&)>;
 
 class BlockStmt : public Stmt {
  public:
   BlockStmt(std::vector<StmtPtr> statements)
-      : statements_(std::move(statements)) {}
+      : Stmt(StmtKind::BLOCK), statements_(std::move(statements)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   std::vector<StmtPtr> statements_;
 };
 
 class ExprStmt : public Stmt {
  public:
-  ExprStmt(ExprPtr expr) : expr_(std::move(expr)) {}
+  ExprStmt(ExprPtr expr) : Stmt(StmtKind::EXPRESSION), expr_(std::move(expr)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   ExprPtr expr_;
 };
 
 class PrintStmt : public Stmt {
  public:
-  PrintStmt(ExprPtr expr) : expr_(std::move(expr)) {}
+  PrintStmt(ExprPtr expr) : Stmt(StmtKind::PRINT), expr_(std::move(expr)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   ExprPtr expr_;
 };
@@ -47,22 +79,31 @@ class PrintStmt : public Stmt {
 class VarStmt : public Stmt {
  public:
   VarStmt(Token name, ExprPtr initializer)
-      : name_(std::move(name)), initializer_(std::move(initializer)) {}
+      : Stmt(StmtKind::VAR),
+        name_(std::move(name)),
+        initializer_(std::move(initializer)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   Token name_;
   ExprPtr initializer_;
+  // Resolver 写入：全局声明时为全局变量表下标，局部声明时为栈帧槽位
+  VariableRef ref_;
 };
 
 class IfStmt : public Stmt {
  public:
   IfStmt(ExprPtr condition, StmtPtr then_branch, StmtPtr else_branch)
-      : condition_(std::move(condition)),
+      : Stmt(StmtKind::IF),
+        condition_(std::move(condition)),
         then_branch_(std::move(then_branch)),
         else_branch_(std::move(else_branch)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   ExprPtr condition_;
   StmtPtr then_branch_;
@@ -72,9 +113,13 @@ class IfStmt : public Stmt {
 class WhileStmt : public Stmt {
  public:
   WhileStmt(ExprPtr condition, StmtPtr body)
-      : condition_(std::move(condition)), body_(std::move(body)) {}
+      : Stmt(StmtKind::WHILE),
+        condition_(std::move(condition)),
+        body_(std::move(body)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   ExprPtr condition_;
   StmtPtr body_;
@@ -82,9 +127,14 @@ class WhileStmt : public Stmt {
 
 class BreakStmt : public Stmt {
  public:
-  BreakStmt() = default;
+  explicit BreakStmt(Token keyword)
+      : Stmt(StmtKind::BREAK), keyword_(std::move(keyword)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
+
+  Token keyword_;
 };
 
 class FunctionStmt : public Stmt {
@@ -92,27 +142,51 @@ class FunctionStmt : public Stmt {
   FunctionStmt(Token name, std::vector<Token> parameters,
                std::vector<StmtPtr> body, bool is_static = false,
                bool is_getter = false)
-      : name_(std::move(name)),
+      : Stmt(StmtKind::FUNCTION),
+        name_(std::move(name)),
         parameters_(std::move(parameters)),
         body_(std::move(body)),
         is_static_(is_static),
         is_getter_(is_getter) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   Token name_;
   std::vector<Token> parameters_;
   std::vector<StmtPtr> body_;
   bool is_static_ = false;
   bool is_getter_ = false;
+  VariableRef ref_;
+
+  // 以下由 Resolver 写入。
+  // 栈帧大小：参数、方法的 this（紧跟在参数之后）和函数体内的局部变量
+  int frame_size_ = 0;
+  // 被内层闭包捕获的参数（含 this）槽位，进入函数时装进 Cell
+  std::vector<int> captured_parameters_;
+  // 创建闭包时要捕获的外层变量：is_local 为真时取外层栈帧 index 槽位的
+  // Cell，否则取外层闭包的第 index 个 upvalue
+  struct Upvalue {
+    bool is_local;
+    int index;
+  };
+  std::vector<Upvalue> upvalues_;
+
+  // 闭包编译后端编译出的函数体；为空时按 AST 解释执行 body_
+  CompiledStmt compiled_body_;
 };
 
 class ReturnStmt : public Stmt {
  public:
   ReturnStmt(Token keyword, ExprPtr value)
-      : keyword_(std::move(keyword)), value_(std::move(value)) {}
+      : Stmt(StmtKind::RETURN),
+        keyword_(std::move(keyword)),
+        value_(std::move(value)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   Token keyword_;
   ExprPtr value_;
@@ -121,15 +195,21 @@ class ReturnStmt : public Stmt {
 class ClassStmt : public Stmt {
  public:
   ClassStmt(Token name, ExprPtr superclass, std::vector<FunctionStmt> methods)
-      : name_(std::move(name)),
+      : Stmt(StmtKind::CLASS),
+        name_(std::move(name)),
         superclass_(std::move(superclass)),
         methods_(std::move(methods)) {}
 
-  void Accept(StmtVisitor& visitor) override { visitor.Visit(*this); }
+  Completion Accept(StmtVisitor& visitor) override {
+    return visitor.Visit(*this);
+  }
 
   Token name_;
   ExprPtr superclass_;
   std::vector<FunctionStmt> methods_;
+  VariableRef ref_;
+  // 有父类时 super 所在的位置，包围所有方法
+  VariableRef super_ref_;
 };
 
 }  // namespace lox
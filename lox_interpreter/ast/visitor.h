@@ -2,6 +2,8 @@
 #define LOX_AST_VISITOR_H_
 
 #include "lox_interpreter/util/lox_object.h"
+#include "lox_interpreter/util/completion.h"
+
 namespace lox {
 
 class BinaryExpr;
@@ -48,16 +50,16 @@ class StmtVisitor {
  public:
   virtual ~StmtVisitor() = default;
 
-  virtual void Visit(BlockStmt& block_stmt) = 0;
-  virtual void Visit(ExprStmt& expr_stmt) = 0;
-  virtual void Visit(PrintStmt& print_stmt) = 0;
-  virtual void Visit(VarStmt& var_stmt) = 0;
-  virtual void Visit(IfStmt& if_stmt) = 0;
-  virtual void Visit(WhileStmt& while_stmt) = 0;
-  virtual void Visit(BreakStmt& break_stmt) = 0;
-  virtual void Visit(FunctionStmt& function_stmt) = 0;
-  virtual void Visit(ReturnStmt& return_stmt) = 0;
-  virtual void Visit(ClassStmt& class_stmt) = 0;
+  virtual Completion Visit(BlockStmt& block_stmt) = 0;
+  virtual Completion Visit(ExprStmt& expr_stmt) = 0;
+  virtual Completion Visit(PrintStmt& print_stmt) = 0;
+  virtual Completion Visit(VarStmt& var_stmt) = 0;
+  virtual Completion Visit(IfStmt& if_stmt) = 0;
+  virtual Completion Visit(WhileStmt& while_stmt) = 0;
+  virtual Completion Visit(BreakStmt& break_stmt) = 0;
+  virtual Completion Visit(FunctionStmt& function_stmt) = 0;
+  virtual Completion Visit(ReturnStmt& return_stmt) = 0;
+  virtual Completion Visit(ClassStmt& class_stmt) = 0;
 };
 
 }  // namespace lox
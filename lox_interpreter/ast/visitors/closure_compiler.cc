@@ -0,0 +1,526 @@
+#include "lox_interpreter/ast/visitors/closure_compiler.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lox_interpreter/util/lox_callable.h"
+#include "lox_interpreter/util/lox_class.h"
+#include "lox_interpreter/util/runtime_error.h"
+
+namespace lox {
+
+namespace {
+
+// 两个操作数都必须是数字的二元运算，apply 在编译时就确定下来
+template <typename Apply>
+CompiledExpr NumberBinary(CompiledExpr left, CompiledExpr right,
+                          const Token* op, Apply apply) {
+  return [left = std::move(left), right = std::move(right), op,
+          apply](Interpreter& interpreter) -> LoxObject {
+    LoxObject a = left(interpreter);
+    LoxObject b = right(interpreter);
+    if (!a.is<double>() || !b.is<double>()) {
+      throw RuntimeError(*op, "Operands must be numbers.");
+    }
+    return apply(a.get<double>(), b.get<double>());
+  };
+}
+
+}  // namespace
+
+std::vector<CompiledStmt> ClosureCompiler::Compile(
+    const std::vector<StmtPtr>& statements) {
+  std::vector<CompiledStmt> compiled;
+  compiled.reserve(statements.size());
+  for (auto& statement : statements) {
+    compiled.push_back(Compile(*statement));
+  }
+  return compiled;
+}
+
+CompiledExpr ClosureCompiler::Compile(Expr& expr) {
+  expr.Accept(*this);
+  return std::move(compiled_expr_);
+}
+
+CompiledStmt ClosureCompiler::Compile(Stmt& stmt) {
+  stmt.Accept(*this);
+  return std::move(compiled_stmt_);
+}
+
+CompiledStmt ClosureCompiler::CompileSequence(
+    const std::vector<StmtPtr>& statements) {
+  return [compiled = Compile(statements)](Interpreter& interpreter) {
+    for (auto& statement : compiled) {
+      Completion completion = statement(interpreter);
+      if (completion != Completion::NORMAL) {
+        return completion;
+      }
+    }
+    return Completion::NORMAL;
+  };
+}
+
+std::vector<CompiledExpr> ClosureCompiler::CompileArguments(
+    const std::vector<ExprPtr>& arguments) {
+  std::vector<CompiledExpr> compiled;
+  compiled.reserve(arguments.size());
+  for (auto& argument : arguments) {
+    compiled.push_back(Compile(*argument));
+  }
+  return compiled;
+}
+
+void ClosureCompiler::CompileFunction(FunctionStmt& function) {
+  function.compiled_body_ = CompileSequence(function.body_);
+}
+
+CompiledExpr ClosureCompiler::CompileLookUp(const Token& name,
+                                            const VariableRef& ref) {
+  int slot = ref.slot;
+  switch (ref.kind) {
+    case VariableRef::Kind::LOCAL:
+      return [slot](Interpreter& interpreter) {
+        return interpreter.stack_.value(interpreter.fp_ + slot);
+      };
+    case VariableRef::Kind::CELL:
+      return [slot](Interpreter& interpreter) {
+        return interpreter.stack_.cell(interpreter.fp_ + slot)->value;
+      };
+    case VariableRef::Kind::UPVALUE:
+      return [slot](Interpreter& interpreter) {
+        return (*interpreter.upvalues_)[slot]->value;
+      };
+    case VariableRef::Kind::GLOBAL:
+      break;
+  }
+  return [name = &name, slot](Interpreter& interpreter) {
+    return interpreter.globals_.Get(slot, *name);
+  };
+}
+
+size_t ClosureCompiler::PushArguments(
+    Interpreter& interpreter, const std::vector<CompiledExpr>& arguments) {
+  size_t base = interpreter.sp_;
+  for (auto& argument : arguments) {
+    interpreter.PushArgument(argument(interpreter));
+  }
+  return base;
+}
+
+LoxObject ClosureCompiler::CallValue(Interpreter& interpreter,
+                                     const CallExpr& call,
+                                     const std::vector<CompiledExpr>& arguments,
+                                     const LoxObject& callee) {
+  size_t base = PushArguments(interpreter, arguments);
+  return interpreter.CallCallable(call, callee, base);
+}
+
+LoxObject ClosureCompiler::Visit(LiteralExpr& expr) {
+  compiled_expr_ = [value = expr.value_](Interpreter&) { return value; };
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(GroupingExpr& expr) {
+  compiled_expr_ = Compile(*expr.expression_);
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(UnaryExpr& expr) {
+  CompiledExpr right = Compile(*expr.right_);
+  const Token* op = &expr.op_;
+  switch (expr.op_.type()) {
+    case TokenType::MINUS:
+      compiled_expr_ = [right = std::move(right),
+                        op](Interpreter& interpreter) {
+        LoxObject value = right(interpreter);
+        interpreter.CheckNumberOperand(*op, value);
+        return LoxObject(-value.asNumber());
+      };
+      break;
+    case TokenType::BANG:
+      compiled_expr_ = [right = std::move(right)](Interpreter& interpreter) {
+        return LoxObject(!right(interpreter).isTruthy());
+      };
+      break;
+    default:
+      compiled_expr_ = [right = std::move(right)](Interpreter& interpreter) {
+        right(interpreter);
+        return LoxObject(nullptr);
+      };
+      break;
+  }
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(BinaryExpr& expr) {
+  CompiledExpr left = Compile(*expr.left_);
+  CompiledExpr right = Compile(*expr.right_);
+  const Token* op = &expr.op_;
+  switch (expr.op_.type()) {
+    case TokenType::PLUS:
+      compiled_expr_ = [left = std::move(left), right = std::move(right),
+                        op](Interpreter& interpreter) -> LoxObject {
+        LoxObject a = left(interpreter);
+        LoxObject b = right(interpreter);
+        if (a.is<double>() && b.is<double>()) {
+          return a.get<double>() + b.get<double>();
+        }
+        if (a.is<std::string>() && b.is<std::string>()) {
+          return LoxString::Concat(a.asString(), b.asString());
+        }
+        throw RuntimeError(*op, "Operands must be numbers or strings.");
+      };
+      break;
+    case TokenType::MINUS:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a - b; });
+      break;
+    case TokenType::STAR:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a * b; });
+      break;
+    case TokenType::SLASH:
+      compiled_expr_ = NumberBinary(
+          std::move(left), std::move(right), op, [op](double a, double b) {
+            if (b == 0) {
+              throw RuntimeError(*op, "Division by zero.");
+            }
+            return a / b;
+          });
+      break;
+    case TokenType::GREATER:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a > b; });
+      break;
+    case TokenType::GREATER_EQUAL:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a >= b; });
+      break;
+    case TokenType::LESS:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a < b; });
+      break;
+    case TokenType::LESS_EQUAL:
+      compiled_expr_ =
+          NumberBinary(std::move(left), std::move(right), op,
+                       [](double a, double b) { return a <= b; });
+      break;
+    case TokenType::EQUAL_EQUAL:
+      compiled_expr_ = [left = std::move(left),
+                        right = std::move(right)](Interpreter& interpreter) {
+        LoxObject a = left(interpreter);
+        return LoxObject(a == right(interpreter));
+      };
+      break;
+    case TokenType::BANG_EQUAL:
+      compiled_expr_ = [left = std::move(left),
+                        right = std::move(right)](Interpreter& interpreter) {
+        LoxObject a = left(interpreter);
+        return LoxObject(a != right(interpreter));
+      };
+      break;
+    default:
+      compiled_expr_ = [left = std::move(left),
+                        right = std::move(right)](Interpreter& interpreter) {
+        left(interpreter);
+        right(interpreter);
+        return LoxObject(nullptr);
+      };
+      break;
+  }
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(VariableExpr& variable) {
+  compiled_expr_ = CompileLookUp(variable.name_, variable.ref_);
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(AssignExpr& assign) {
+  CompiledExpr value = Compile(*assign.value_);
+  int slot = assign.ref_.slot;
+  if (assign.ref_.kind == VariableRef::Kind::LOCAL) {
+    compiled_expr_ = [value = std::move(value),
+                      slot](Interpreter& interpreter) {
+      LoxObject result = value(interpreter);
+      interpreter.stack_.value(interpreter.fp_ + slot) = result;
+      return result;
+    };
+  } else if (assign.ref_.kind != VariableRef::Kind::GLOBAL) {
+    compiled_expr_ = [value = std::move(value),
+                      ref = assign.ref_](Interpreter& interpreter) {
+      LoxObject result = value(interpreter);
+      interpreter.SetVariable(ref, result);
+      return result;
+    };
+  } else {
+    compiled_expr_ = [value = std::move(value), name = &assign.name_,
+                      slot](Interpreter& interpreter) {
+      LoxObject result = value(interpreter);
+      interpreter.globals_.Assign(slot, *name, result);
+      return result;
+    };
+  }
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(LogicalExpr& logical) {
+  CompiledExpr left = Compile(*logical.left_);
+  CompiledExpr right = Compile(*logical.right_);
+  if (logical.op_.type() == TokenType::AND) {
+    compiled_expr_ = [left = std::move(left),
+                      right = std::move(right)](Interpreter& interpreter) {
+      LoxObject result = left(interpreter);
+      if (!result.isTruthy()) {
+        return result;
+      }
+      return right(interpreter);
+    };
+  } else {
+    compiled_expr_ = [left = std::move(left),
+                      right = std::move(right)](Interpreter& interpreter) {
+      LoxObject result = left(interpreter);
+      if (result.isTruthy()) {
+        return result;
+      }
+      return right(interpreter);
+    };
+  }
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(CallExpr& call) {
+  std::vector<CompiledExpr> arguments = CompileArguments(call.arguments_);
+  if (call.method_ == nullptr) {
+    compiled_expr_ = [callee = Compile(*call.callee_),
+                      arguments = std::move(arguments),
+                      call = &call](Interpreter& interpreter) {
+      return CallValue(interpreter, *call, arguments, callee(interpreter));
+    };
+    return nullptr;
+  }
+
+  // obj.method(...)：与 Interpreter::CallMethod 相同，查到方法后直接以
+  // obj 为 this 调用，属性是字段或 getter 时退回普通调用
+  GetExpr* get = call.method_;
+  compiled_expr_ = [object = Compile(*get->object_),
+                    arguments = std::move(arguments), call = &call,
+                    get](Interpreter& interpreter) -> LoxObject {
+    LoxObject receiver = object(interpreter);
+    if (receiver.index() != TypeIndex::INSTANCE) {
+      return CallValue(interpreter, *call, arguments,
+                       interpreter.GetProperty(*get, receiver));
+    }
+
+    LoxInstance& instance = receiver.get<LoxInstance>();
+    PropertyCache::Entry entry = instance.Lookup(get->name_, get->cache_);
+    if (entry.kind != PropertyCache::Kind::METHOD) {
+      return CallValue(interpreter, *call, arguments,
+                       instance.ApplyGet(entry, interpreter));
+    }
+
+    size_t base = PushArguments(interpreter, arguments);
+    interpreter.CheckArity(*call, *entry.method, interpreter.sp_ - base);
+    LoxObject result = entry.method->Call(interpreter, receiver, base);
+    interpreter.sp_ = base;
+    return result;
+  };
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(GetExpr& get) {
+  compiled_expr_ = [object = Compile(*get.object_),
+                    get = &get](Interpreter& interpreter) {
+    return interpreter.GetProperty(*get, object(interpreter));
+  };
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(SetExpr& set) {
+  compiled_expr_ = [object = Compile(*set.object_),
+                    value = Compile(*set.value_),
+                    set = &set](Interpreter& interpreter) {
+    LoxObject target = object(interpreter);
+    if (!target.is<LoxInstance>()) {
+      throw RuntimeError(set->name_, "Only instances have fields.");
+    }
+
+    LoxObject result = value(interpreter);
+    if (target.index() == TypeIndex::INSTANCE) {
+      target.get<LoxInstance>().Set(set->name_, result, set->cache_);
+    } else {
+      target.get<LoxInstance>().Set(set->name_, result);
+    }
+    return result;
+  };
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(ThisExpr& this_expr) {
+  compiled_expr_ = CompileLookUp(this_expr.keyword_, this_expr.ref_);
+  return nullptr;
+}
+
+LoxObject ClosureCompiler::Visit(SuperExpr& super_expr) {
+  // super.method 没有子表达式，直接交给解释器
+  compiled_expr_ = [super_expr = &super_expr](Interpreter& interpreter) {
+    return interpreter.Visit(*super_expr);
+  };
+  return nullptr;
+}
+
+// 块内变量就是当前栈帧中的槽位，块本身只是一串语句
+Completion ClosureCompiler::Visit(BlockStmt& block_stmt) {
+  compiled_stmt_ = CompileSequence(block_stmt.statements_);
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(ExprStmt& expr_stmt) {
+  compiled_stmt_ = [expr = Compile(*expr_stmt.expr_)](Interpreter& interpreter) {
+    expr(interpreter);
+    return Completion::NORMAL;
+  };
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(PrintStmt& print_stmt) {
+  compiled_stmt_ =
+      [expr = Compile(*print_stmt.expr_)](Interpreter& interpreter) {
+        interpreter.output_.Print(expr(interpreter));
+        return Completion::NORMAL;
+      };
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(VarStmt& var_stmt) {
+  CompiledExpr initializer;
+  if (var_stmt.initializer_ != nullptr) {
+    initializer = Compile(*var_stmt.initializer_);
+  } else {
+    initializer = [](Interpreter&) { return LoxObject(nullptr); };
+  }
+
+  // 变量的存放位置在编译时就已确定，不必像 DefineVariable 那样运行时判断
+  int slot = var_stmt.ref_.slot;
+  switch (var_stmt.ref_.kind) {
+    case VariableRef::Kind::GLOBAL:
+      compiled_stmt_ = [initializer = std::move(initializer),
+                        slot](Interpreter& interpreter) {
+        interpreter.globals_.Define(slot, initializer(interpreter));
+        return Completion::NORMAL;
+      };
+      break;
+    case VariableRef::Kind::LOCAL:
+      compiled_stmt_ = [initializer = std::move(initializer),
+                        slot](Interpreter& interpreter) {
+        LoxObject value = initializer(interpreter);
+        interpreter.stack_.value(interpreter.fp_ + slot) = std::move(value);
+        return Completion::NORMAL;
+      };
+      break;
+    default:
+      compiled_stmt_ = [initializer = std::move(initializer),
+                        ref = var_stmt.ref_](Interpreter& interpreter) {
+        interpreter.DefineVariable(ref, initializer(interpreter));
+        return Completion::NORMAL;
+      };
+      break;
+  }
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(IfStmt& if_stmt) {
+  CompiledExpr condition = Compile(*if_stmt.condition_);
+  CompiledStmt then_branch = Compile(*if_stmt.then_branch_);
+  if (if_stmt.else_branch_ == nullptr) {
+    compiled_stmt_ = [condition = std::move(condition),
+                      then_branch = std::move(then_branch)](
+                         Interpreter& interpreter) {
+      if (condition(interpreter).isTruthy()) {
+        return then_branch(interpreter);
+      }
+      return Completion::NORMAL;
+    };
+  } else {
+    compiled_stmt_ = [condition = std::move(condition),
+                      then_branch = std::move(then_branch),
+                      else_branch = Compile(*if_stmt.else_branch_)](
+                         Interpreter& interpreter) {
+      if (condition(interpreter).isTruthy()) {
+        return then_branch(interpreter);
+      }
+      return else_branch(interpreter);
+    };
+  }
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(WhileStmt& while_stmt) {
+  compiled_stmt_ = [condition = Compile(*while_stmt.condition_),
+                    body = Compile(*while_stmt.body_)](
+                       Interpreter& interpreter) {
+    while (condition(interpreter).isTruthy()) {
+      Completion completion = body(interpreter);
+      if (completion == Completion::BREAK) {
+        break;
+      }
+      if (completion == Completion::RETURN) {
+        return completion;
+      }
+      interpreter.heap_.MaybeCollect();
+    }
+    return Completion::NORMAL;
+  };
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(BreakStmt& break_stmt) {
+  (void)break_stmt;  // 未使用参数
+  compiled_stmt_ = [](Interpreter&) { return Completion::BREAK; };
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(FunctionStmt& function_stmt) {
+  CompileFunction(function_stmt);
+  // 创建函数对象的逻辑与 AST 后端共用，函数体已换成编译结果
+  compiled_stmt_ = [function = &function_stmt](Interpreter& interpreter) {
+    return interpreter.Visit(*function);
+  };
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(ReturnStmt& return_stmt) {
+  if (return_stmt.value_ == nullptr) {
+    compiled_stmt_ = [](Interpreter& interpreter) {
+      interpreter.return_value_ = nullptr;
+      return Completion::RETURN;
+    };
+  } else {
+    compiled_stmt_ =
+        [value = Compile(*return_stmt.value_)](Interpreter& interpreter) {
+          interpreter.return_value_ = value(interpreter);
+          return Completion::RETURN;
+        };
+  }
+  return Completion::NORMAL;
+}
+
+Completion ClosureCompiler::Visit(ClassStmt& class_stmt) {
+  for (auto& method : class_stmt.methods_) {
+    CompileFunction(method);
+  }
+  // 类对象的构建只在声明执行时发生一次，直接交给解释器
+  compiled_stmt_ = [class_stmt = &class_stmt](Interpreter& interpreter) {
+    return interpreter.Visit(*class_stmt);
+  };
+  return Completion::NORMAL;
+}
+
+}  // namespace lox
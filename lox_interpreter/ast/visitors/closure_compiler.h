@@ -0,0 +1,91 @@
+#ifndef LOX_AST_VISITORS_CLOSURE_COMPILER_H_
+#define LOX_AST_VISITORS_CLOSURE_COMPILER_H_
+
+#include <functional>
+#include <vector>
+
+#include "lox_interpreter/ast/visitor.h"
+#include "lox_interpreter/ast/expr.h"
+#include "lox_interpreter/ast/stmt.h"
+#include "lox_interpreter/ast/visitors/interpreter.h"
+
+namespace lox {
+
+// 表达式编译出的闭包，调用即求值
+using CompiledExpr = std::function<LoxObject(Interpreter&)>;
+
+// 闭包编译后端。
+//
+// 把已经过 Resolver 的 AST 一次性编译成一棵预先绑定好的 C++ 闭包树：
+// 每个闭包捕获了操作数对应的子闭包、Resolver 算出的变量位置以及
+// 运算符，执行时不再经过 Accept/Visit 的双重虚派发，也不再按运算符
+// switch。值栈、全局变量表、内联缓存和函数调用约定都直接复用
+// Interpreter 的实现，因此两个后端的语义（包括报错信息）完全一致。
+//
+// 函数体在编译到函数/类声明时一并编译，保存在 FunctionStmt::compiled_body_
+// 中，FunctionCallable 调用时优先使用它。
+//
+// 访问者接口的返回值类型是固定的，编译结果通过 compiled_expr_ 和
+// compiled_stmt_ 传出。
+class ClosureCompiler : public ExprVisitor, public StmtVisitor {
+ public:
+  // 编译一段顶层程序，返回值与 statements 一一对应
+  std::vector<CompiledStmt> Compile(const std::vector<StmtPtr>& statements);
+
+  LoxObject Visit(LiteralExpr& expr) override;
+  LoxObject Visit(GroupingExpr& expr) override;
+  LoxObject Visit(UnaryExpr& expr) override;
+  LoxObject Visit(BinaryExpr& expr) override;
+  LoxObject Visit(VariableExpr& variable) override;
+  LoxObject Visit(AssignExpr& assign) override;
+  LoxObject Visit(LogicalExpr& logical) override;
+  LoxObject Visit(CallExpr& call) override;
+  LoxObject Visit(GetExpr& get) override;
+  LoxObject Visit(SetExpr& set) override;
+  LoxObject Visit(ThisExpr& this_expr) override;
+  LoxObject Visit(SuperExpr& super_expr) override;
+
+  Completion Visit(BlockStmt& block_stmt) override;
+  Completion Visit(ExprStmt& expr_stmt) override;
+  Completion Visit(PrintStmt& print_stmt) override;
+  Completion Visit(VarStmt& var_stmt) override;
+  Completion Visit(IfStmt& if_stmt) override;
+  Completion Visit(WhileStmt& while_stmt) override;
+  Completion Visit(BreakStmt& break_stmt) override;
+  Completion Visit(FunctionStmt& function_stmt) override;
+  Completion Visit(ReturnStmt& return_stmt) override;
+  Completion Visit(ClassStmt& class_stmt) override;
+
+ private:
+  CompiledExpr Compile(Expr& expr);
+  CompiledStmt Compile(Stmt& stmt);
+
+  // 依次执行一组语句，遇到 return / break 立即向外传递
+  CompiledStmt CompileSequence(const std::vector<StmtPtr>& statements);
+
+  std::vector<CompiledExpr> CompileArguments(
+      const std::vector<ExprPtr>& arguments);
+
+  // 编译函数体并保存到 function.compiled_body_
+  void CompileFunction(FunctionStmt& function);
+
+  // 变量读取：按变量的存放位置（栈帧槽位、Cell、upvalue、全局变量表）
+  // 生成对应的闭包
+  static CompiledExpr CompileLookUp(const Token& name, const VariableRef& ref);
+
+  // 与 Interpreter::PushArguments 相同，只是参数已编译成闭包
+  static size_t PushArguments(Interpreter& interpreter,
+                              const std::vector<CompiledExpr>& arguments);
+
+  // 与 Interpreter::CallValue 相同，只是参数已编译成闭包
+  static LoxObject CallValue(Interpreter& interpreter, const CallExpr& call,
+                             const std::vector<CompiledExpr>& arguments,
+                             const LoxObject& callee);
+
+  CompiledExpr compiled_expr_;
+  CompiledStmt compiled_stmt_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_AST_VISITORS_CLOSURE_COMPILER_H_
@@ -1,33 +1,54 @@
 #include "lox_interpreter/ast/visitors/interpreter.h"
 
-#include "lox_interpreter/core/environment.h"
+#include "lox_interpreter/ast/visitors/closure_compiler.h"
 #include "lox_interpreter/core/lox.h"
 #include "lox_interpreter/ast/visitor.h"
 #include "lox_interpreter/ast/expr.h"
 #include "lox_interpreter/ast/stmt.h"
 #include "lox_interpreter/util/lox_object.h"
 #include "lox_interpreter/util/runtime_error.h"
-#include "lox_interpreter/util/break_exception.h"
 #include "lox_interpreter/util/lox_callable.h"
-#include "lox_interpreter/util/return_exception.h"
 #include "lox_interpreter/util/lox_class.h"
 
 #include <vector>
 
 namespace lox {
-Interpreter::Interpreter()
-    : global_env_(std::make_shared<Environment>()), environment_(global_env_) {
-  global_env_->Define("clock", LoxObject(std::make_shared<ClockCallable>()));
+Interpreter::Interpreter() {
+  ObjectPool::Scope pool_scope(*pool_);
+  globals_.Define(globals_.Slot(Symbol::Intern("clock")),
+                  LoxObject(MakeRef<ClockCallable>()));
 }
 
-void Interpreter::Interpret(std::vector<StmtPtr> statements) {
+void Interpreter::Interpret(std::vector<StmtPtr> statements,
+                            std::unique_ptr<AstArena> arena) {
+  ObjectPool::Scope pool_scope(*pool_);
+  programs_.push_back(Program{std::move(arena), std::move(statements)});
+  // 顶层代码的栈帧从 0 号槽位开始
+  fp_ = 0;
+  sp_ = top_level_slots_;
+  upvalues_ = nullptr;
+  stack_.Reserve(sp_);
   try {
-    for (auto& statement : statements) {
-      Execute(statement);
+    if (backend_ == Backend::CLOSURE) {
+      ClosureCompiler compiler;
+      for (auto& statement : compiler.Compile(programs_.back().statements)) {
+        statement(*this);
+        heap_.MaybeCollect();
+      }
+    } else {
+      for (auto& statement : programs_.back().statements) {
+        Execute(statement);
+        heap_.MaybeCollect();
+      }
     }
   } catch (const RuntimeError& error) {
+    // 先写出出错前 print 的内容，错误信息排在它们之后
+    output_.Flush();
     Lox::Instance().RuntimeError(error);
   }
+  output_.Flush();
+  // 出错时调用中途的栈帧没有弹出，连同顶层栈帧一起清空
+  stack_.Clear(0, stack_.size());
 }
 
 LoxObject Interpreter::Visit(LiteralExpr& expr) { return expr.value_; }
@@ -38,52 +59,89 @@ LoxObject Interpreter::Visit(GroupingExpr& expr) {
 
 LoxObject Interpreter::Visit(UnaryExpr& expr) {
   LoxObject right = Evaluate(expr.right_);
-  switch (expr.op_.type()) {
-    case TokenType::MINUS:
-      return -right.get<double>();
-    case TokenType::BANG:
-      return !right.isTruthy();
+  if (expr.op_.type() != TokenType::MINUS) {
+    return !right.isTruthy();
+  }
+
+  switch (expr.specialization_) {
+    case Specialization::NUMBER:
+      if (right.is<double>()) {
+        return -right.asNumber();
+      }
+      expr.specialization_ = Specialization::GENERIC;
+      break;
+    case Specialization::UNINITIALIZED:
+      expr.specialization_ = right.is<double>() ? Specialization::NUMBER
+                                                : Specialization::GENERIC;
+      break;
     default:
-      return nullptr;
+      break;
   }
+  CheckNumberOperand(expr.op_, right);
+  return -right.asNumber();
 }
 
 LoxObject Interpreter::Visit(BinaryExpr& expr) {
   LoxObject left = Evaluate(expr.left_);
   LoxObject right = Evaluate(expr.right_);
-  switch (expr.op_.type()) {
-    case TokenType::PLUS:
+  switch (expr.specialization_) {
+    case Specialization::NUMBER:
       if (left.is<double>() && right.is<double>()) {
-        return left.get<double>() + right.get<double>();
+        return NumberBinary(expr, left.asNumber(), right.asNumber());
       }
+      break;
+    case Specialization::STRING:
       if (left.is<std::string>() && right.is<std::string>()) {
-        return left.get<std::string>() + right.get<std::string>();
+        return StringBinary(expr, left.asString(), right.asString());
       }
-      throw RuntimeError(expr.op_, "Operands must be numbers or strings.");
+      break;
+    case Specialization::GENERIC:
+      return GenericBinary(expr, left, right);
+    case Specialization::UNINITIALIZED:
+      // 第一次执行：记下操作数类型，本次仍走通用版本
+      expr.specialization_ = Specialize(expr.op_.type(), left, right);
+      return GenericBinary(expr, left, right);
+  }
+  // 守卫失败：退化为通用版本
+  expr.specialization_ = Specialization::GENERIC;
+  return GenericBinary(expr, left, right);
+}
+
+Specialization Interpreter::Specialize(TokenType op, const LoxObject& left,
+                                       const LoxObject& right) {
+  if (left.is<double>() && right.is<double>()) {
+    return Specialization::NUMBER;
+  }
+  if (left.is<std::string>() && right.is<std::string>() &&
+      (op == TokenType::PLUS || op == TokenType::EQUAL_EQUAL ||
+       op == TokenType::BANG_EQUAL)) {
+    return Specialization::STRING;
+  }
+  return Specialization::GENERIC;
+}
+
+LoxObject Interpreter::NumberBinary(const BinaryExpr& expr, double left,
+                                    double right) {
+  switch (expr.op_.type()) {
+    case TokenType::PLUS:
+      return left + right;
     case TokenType::MINUS:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() - right.get<double>();
+      return left - right;
     case TokenType::STAR:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() * right.get<double>();
+      return left * right;
     case TokenType::SLASH:
-      CheckNumberOperands(expr.op_, left, right);
-      if (right.get<double>() == 0) {
+      if (right == 0) {
         throw RuntimeError(expr.op_, "Division by zero.");
       }
-      return left.get<double>() / right.get<double>();
+      return left / right;
     case TokenType::GREATER:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() > right.get<double>();
+      return left > right;
     case TokenType::GREATER_EQUAL:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() >= right.get<double>();
+      return left >= right;
     case TokenType::LESS:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() < right.get<double>();
+      return left < right;
     case TokenType::LESS_EQUAL:
-      CheckNumberOperands(expr.op_, left, right);
-      return left.get<double>() <= right.get<double>();
+      return left <= right;
     case TokenType::EQUAL_EQUAL:
       return left == right;
     case TokenType::BANG_EQUAL:
@@ -93,18 +151,50 @@ LoxObject Interpreter::Visit(BinaryExpr& expr) {
   }
 }
 
+LoxObject Interpreter::StringBinary(const BinaryExpr& expr,
+                                    const LoxString& left,
+                                    const LoxString& right) {
+  switch (expr.op_.type()) {
+    case TokenType::PLUS:
+      return LoxString::Concat(left, right);
+    case TokenType::EQUAL_EQUAL:
+      return left == right;
+    case TokenType::BANG_EQUAL:
+      return !(left == right);
+    default:
+      return nullptr;
+  }
+}
+
+LoxObject Interpreter::GenericBinary(const BinaryExpr& expr,
+                                     const LoxObject& left,
+                                     const LoxObject& right) {
+  switch (expr.op_.type()) {
+    case TokenType::PLUS:
+      if (left.is<double>() && right.is<double>()) {
+        return left.get<double>() + right.get<double>();
+      }
+      if (left.is<std::string>() && right.is<std::string>()) {
+        return LoxString::Concat(left.asString(), right.asString());
+      }
+      throw RuntimeError(expr.op_, "Operands must be numbers or strings.");
+    case TokenType::EQUAL_EQUAL:
+      return left == right;
+    case TokenType::BANG_EQUAL:
+      return left != right;
+    default:
+      CheckNumberOperands(expr.op_, left, right);
+      return NumberBinary(expr, left.asNumber(), right.asNumber());
+  }
+}
+
 LoxObject Interpreter::Visit(VariableExpr& variable) {
-  return LookUpVariable(variable.name_, &variable);
+  return LookUpVariable(variable.name_, variable.ref_);
 }
 
 LoxObject Interpreter::Visit(AssignExpr& assign) {
   LoxObject value = Evaluate(assign.value_);
-  if (locals_.find(&assign) != locals_.end()) {
-    int distance = locals_.at(&assign);
-    environment_->AssignAt(assign.name_.lexeme(), value, distance);
-  } else {
-    global_env_->Assign(assign.name_, value);
-  }
+  AssignVariable(assign.name_, assign.ref_, value);
   return value;
 }
 
@@ -122,65 +212,80 @@ LoxObject Interpreter::Visit(LogicalExpr& logical) {
   return Evaluate(logical.right_);
 }
 
-void Interpreter::Visit(BlockStmt& block_stmt) {
-  ExecuteBlock(block_stmt.statements_,
-               std::make_shared<Environment>(environment_));
+Completion Interpreter::Visit(BlockStmt& block_stmt) {
+  return ExecuteBlock(block_stmt.statements_);
 }
 
-void Interpreter::Visit(ExprStmt& expr_stmt) { Evaluate(expr_stmt.expr_); }
+Completion Interpreter::Visit(ExprStmt& expr_stmt) {
+  Evaluate(expr_stmt.expr_);
+  return Completion::NORMAL;
+}
 
-void Interpreter::Visit(PrintStmt& print_stmt) {
-  std::cout << Evaluate(print_stmt.expr_).ToString() << std::endl;
+Completion Interpreter::Visit(PrintStmt& print_stmt) {
+  output_.Print(Evaluate(print_stmt.expr_));
+  return Completion::NORMAL;
 }
 
-void Interpreter::Visit(VarStmt& var_stmt) {
+Completion Interpreter::Visit(VarStmt& var_stmt) {
   LoxObject value = nullptr;
   if (var_stmt.initializer_ != nullptr) {
     value = Evaluate(var_stmt.initializer_);
   }
-  environment_->Define(var_stmt.name_.lexeme(), value);
+  DefineVariable(var_stmt.ref_, std::move(value));
+  return Completion::NORMAL;
 }
 
-void Interpreter::Visit(IfStmt& if_stmt) {
+Completion Interpreter::Visit(IfStmt& if_stmt) {
   if (Evaluate(if_stmt.condition_).isTruthy()) {
-    Execute(if_stmt.then_branch_);
+    return Execute(if_stmt.then_branch_);
   } else if (if_stmt.else_branch_ != nullptr) {
-    Execute(if_stmt.else_branch_);
+    return Execute(if_stmt.else_branch_);
   }
+  return Completion::NORMAL;
 }
 
-void Interpreter::Visit(WhileStmt& while_stmt) {
+Completion Interpreter::Visit(WhileStmt& while_stmt) {
   while (Evaluate(while_stmt.condition_).isTruthy()) {
-    try {
-      Execute(while_stmt.body_);
-    } catch (const BreakException&) {
+    Completion completion = Execute(while_stmt.body_);
+    if (completion == Completion::BREAK) {
       break;
     }
+    if (completion == Completion::RETURN) {
+      return completion;
+    }
+    heap_.MaybeCollect();
   }
+  return Completion::NORMAL;
 }
 
-void Interpreter::Visit(BreakStmt& break_stmt) {
+Completion Interpreter::Visit(BreakStmt& break_stmt) {
   (void)break_stmt;  // 未使用参数
-  throw BreakException();
+  return Completion::BREAK;
 }
 
-void Interpreter::Visit(FunctionStmt& function_stmt) {
-  std::string function_name = function_stmt.name_.lexeme();
-  LoxObject function = LoxObject(std::make_shared<FunctionCallable>(
-      std::move(function_stmt), environment_, false));
-  environment_->Define(function_name, function);
+Completion Interpreter::Visit(FunctionStmt& function_stmt) {
+  // 先定义变量再创建闭包：函数可能通过被捕获的变量递归引用自己
+  DefineVariable(function_stmt.ref_, nullptr);
+  SetVariable(function_stmt.ref_,
+              LoxObject(MakeRef<FunctionCallable>(
+                  &function_stmt, CaptureUpvalues(function_stmt), false)));
+  return Completion::NORMAL;
 }
 
-void Interpreter::Visit(ReturnStmt& return_stmt) {
-  LoxObject value = nullptr;
+Completion Interpreter::Visit(ReturnStmt& return_stmt) {
+  return_value_ = nullptr;
   if (return_stmt.value_ != nullptr) {
-    value = Evaluate(return_stmt.value_);
+    return_value_ = Evaluate(return_stmt.value_);
   }
-  throw ReturnException(value);
+  return Completion::RETURN;
 }
 
-void Interpreter::Visit(ClassStmt& class_stmt) {
-  std::shared_ptr<LoxClass> super_class = nullptr;
+Completion Interpreter::Visit(ClassStmt& class_stmt) {
+  // 方法可能通过被捕获的变量引用类自己，先为它建好 Cell
+  if (class_stmt.ref_.kind == VariableRef::Kind::CELL) {
+    DefineVariable(class_stmt.ref_, nullptr);
+  }
+  Ref<LoxClass> super_class = nullptr;
   if (class_stmt.superclass_ != nullptr) {
     LoxObject super_class_obj = Evaluate(class_stmt.superclass_);
     if (!super_class_obj.is<LoxClass>()) {
@@ -188,29 +293,27 @@ void Interpreter::Visit(ClassStmt& class_stmt) {
           static_cast<VariableExpr&>(*class_stmt.superclass_).name_,
           "Superclass must be a class.");
     }
-    super_class = super_class_obj.get<std::shared_ptr<LoxClass>>();
+    super_class = super_class_obj.get<Ref<LoxClass>>();
   }
 
-  environment_->Define(class_stmt.name_.lexeme(), nullptr);
-
+  // super 是包裹所有方法的作用域中的变量，由方法作为 upvalue 捕获
   if (class_stmt.superclass_ != nullptr) {
-    environment_ = std::shared_ptr<Environment>(environment_);
-    environment_->Define("super", super_class);
+    DefineVariable(class_stmt.super_ref_, LoxObject(super_class));
   }
 
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>> methods;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-      static_methods;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>> getters;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-      static_getters;
+  static const Symbol kInit = Symbol::Intern("init");
+  MethodTable methods;
+  MethodTable static_methods;
+  MethodTable getters;
+  MethodTable static_getters;
   for (auto& method : class_stmt.methods_) {
-    std::string method_name = method.name_.lexeme();
+    Symbol method_name = method.name_.symbol();
     bool is_static = method.is_static_;
     bool is_getter = method.is_getter_;
     // Getters are not initializers and have no parameters
-    auto func = std::make_shared<FunctionCallable>(
-        std::move(method), environment_, !is_getter && method_name == "init");
+    auto func = MakeRef<FunctionCallable>(
+        &method, CaptureUpvalues(method), !is_getter && method_name == kInit,
+        true);
     if (is_getter) {
       if (is_static) {
         static_getters[method_name] = func;
@@ -224,46 +327,91 @@ void Interpreter::Visit(ClassStmt& class_stmt) {
     }
   }
 
-  // 直接创建 shared_ptr，避免不必要的拷贝
-  std::shared_ptr<LoxClass> kClass = std::make_shared<LoxClass>(
-      class_stmt.name_.lexeme(), std::move(super_class), std::move(methods),
+  Ref<LoxClass> kClass = MakeRef<LoxClass>(
+      std::string(class_stmt.name_.lexeme()), super_class, std::move(methods),
       std::move(static_methods), std::move(getters), std::move(static_getters));
 
-  if (super_class != nullptr) {
-    environment_ = environment_->Enclosing();
+  SetVariable(class_stmt.ref_, LoxObject(kClass));
+  return Completion::NORMAL;
+}
+
+LoxObject Interpreter::Visit(CallExpr& call) {
+  if (call.method_ != nullptr) {
+    return CallMethod(call);
+  }
+  return CallValue(call, Evaluate(call.callee_));
+}
+
+// obj.method(...)：查到方法后直接以 obj 为 this 调用，不创建绑定方法对象。
+// 属性是字段或 getter 时退回普通调用
+LoxObject Interpreter::CallMethod(CallExpr& call) {
+  GetExpr& get = *call.method_;
+  LoxObject object = Evaluate(get.object_);
+  if (object.index() != TypeIndex::INSTANCE) {
+    return CallValue(call, GetProperty(get, object));
+  }
+
+  LoxInstance& instance = object.get<LoxInstance>();
+  PropertyCache::Entry entry = instance.Lookup(get.name_, get.cache_);
+  if (entry.kind != PropertyCache::Kind::METHOD) {
+    return CallValue(call, instance.ApplyGet(entry, *this));
   }
 
-  environment_->Assign(class_stmt.name_, LoxObject(kClass));
+  size_t arguments = PushArguments(call.arguments_);
+  CheckArity(call, *entry.method, sp_ - arguments);
+  LoxObject result = entry.method->Call(*this, object, arguments);
+  sp_ = arguments;
+  return result;
 }
 
-LoxObject Interpreter::Visit(CallExpr& call) {
-  LoxObject callee = Evaluate(call.callee_);
-  std::vector<LoxObject> arguments;
-  for (auto& argument : call.arguments_) {
-    arguments.push_back(Evaluate(argument));
+LoxObject Interpreter::CallValue(CallExpr& call, const LoxObject& callee) {
+  return CallCallable(call, callee, PushArguments(call.arguments_));
+}
+
+size_t Interpreter::PushArguments(std::vector<ExprPtr>& arguments) {
+  size_t base = sp_;
+  for (auto& argument : arguments) {
+    PushArgument(Evaluate(argument));
   }
+  return base;
+}
+
+LoxObject Interpreter::CallCallable(const CallExpr& call,
+                                    const LoxObject& callee,
+                                    size_t arguments) {
   if (!callee.is<LoxCallable>() && !callee.is<LoxClass>()) {
     throw RuntimeError(call.paren_, "Can only call functions and classes.");
   }
 
-  LoxCallable& callable = callee.is<LoxCallable>()
-                              ? *callee.get<std::shared_ptr<LoxCallable>>()
-                              : *callee.get<std::shared_ptr<LoxClass>>();
-  if (callable.arity() != arguments.size()) {
+  LoxCallable& callable = callee.get<LoxCallable>();
+  CheckArity(call, callable, sp_ - arguments);
+  LoxObject result = callable(*this, arguments);
+  sp_ = arguments;
+  return result;
+}
+
+void Interpreter::CheckArity(const CallExpr& call, LoxCallable& callable,
+                             size_t argument_count) {
+  if (callable.arity() != argument_count) {
     throw RuntimeError(call.paren_, "Expected " +
                                         std::to_string(callable.arity()) +
                                         " arguments but got " +
-                                        std::to_string(arguments.size()));
+                                        std::to_string(argument_count));
   }
-  return callable(*this, std::move(arguments));
 }
 
 LoxObject Interpreter::Visit(GetExpr& expr) {
-  LoxObject object = Evaluate(expr.object_);
+  return GetProperty(expr, Evaluate(expr.object_));
+}
+
+LoxObject Interpreter::GetProperty(GetExpr& expr, const LoxObject& object) {
   if (!object.is<LoxInstance>()) {
     throw RuntimeError(expr.name_, "Only instances have properties.");
   }
-  return object.get<std::shared_ptr<LoxInstance>>()->Get(expr.name_, *this);
+  if (object.index() == TypeIndex::INSTANCE) {
+    return object.get<LoxInstance>().Get(expr.name_, *this, expr.cache_);
+  }
+  return object.get<LoxInstance>().Get(expr.name_, *this);
 }
 
 LoxObject Interpreter::Visit(SetExpr& expr) {
@@ -273,74 +421,213 @@ LoxObject Interpreter::Visit(SetExpr& expr) {
   }
 
   LoxObject value = Evaluate(expr.value_);
-  object.get<std::shared_ptr<LoxInstance>>()->Set(expr.name_, value);
+  if (object.index() == TypeIndex::INSTANCE) {
+    object.get<LoxInstance>().Set(expr.name_, value, expr.cache_);
+  } else {
+    object.get<LoxInstance>().Set(expr.name_, value);
+  }
   return value;
 }
 
 LoxObject Interpreter::Visit(ThisExpr& this_expr) {
-  return LookUpVariable(this_expr.keyword_, &this_expr);
+  return LookUpVariable(this_expr.keyword_, this_expr.ref_);
 }
 
 LoxObject Interpreter::Visit(SuperExpr& super_expr) {
-  int distance = locals_.at(&super_expr);
-  auto super_class =
-      environment_->GetAt("super", distance).get<std::shared_ptr<LoxClass>>();
-  auto object = environment_->GetAt("this", distance - 1)
-                    .get<std::shared_ptr<LoxInstance>>();
-  auto method = super_class->FindMethod(super_expr.method_.lexeme());
+  auto super_class = LookUpVariable(super_expr.keyword_, super_expr.ref_)
+                         .get<Ref<LoxClass>>();
+  LoxObject object = LookUpVariable(super_expr.keyword_, super_expr.this_ref_);
+  auto method = super_class->FindMethod(super_expr.method_.symbol());
 
   if (method != nullptr) {
-    return LoxObject(method->Bind(LoxObject(object)));
+    return LoxObject(method->Bind(object));
   }
 
-  auto getter = super_class->FindGetter(super_expr.method_.lexeme());
+  auto getter = super_class->FindGetter(super_expr.method_.symbol());
   if (getter != nullptr) {
-    auto bound_getter = getter->Bind(LoxObject(object));
-    return (*bound_getter)(*this, {});
+    return getter->Call(*this, object);
   }
 
-  throw RuntimeError(
-      super_expr.method_,
-      "Undefined property '" + super_expr.method_.lexeme() + "'.");
+  throw RuntimeError(super_expr.method_,
+                     "Undefined property '" +
+                         std::string(super_expr.method_.lexeme()) + "'.");
+}
+
+LoxObject Interpreter::Evaluate(ExprPtr& expr) { return Evaluate(*expr); }
+
+LoxObject Interpreter::Evaluate(Expr& expr) {
+#ifdef LOX_SELECTABLE_DISPATCH
+  dispatched_nodes_++;
+  if (dispatch_ == Dispatch::VIRTUAL) {
+    return expr.Accept(*this);
+  }
+#endif
+  switch (expr.kind()) {
+    case ExprKind::BINARY:
+      return Visit(static_cast<BinaryExpr&>(expr));
+    case ExprKind::UNARY:
+      return Visit(static_cast<UnaryExpr&>(expr));
+    case ExprKind::LITERAL:
+      return Visit(static_cast<LiteralExpr&>(expr));
+    case ExprKind::GROUPING:
+      return Visit(static_cast<GroupingExpr&>(expr));
+    case ExprKind::VARIABLE:
+      return Visit(static_cast<VariableExpr&>(expr));
+    case ExprKind::ASSIGN:
+      return Visit(static_cast<AssignExpr&>(expr));
+    case ExprKind::LOGICAL:
+      return Visit(static_cast<LogicalExpr&>(expr));
+    case ExprKind::CALL:
+      return Visit(static_cast<CallExpr&>(expr));
+    case ExprKind::GET:
+      return Visit(static_cast<GetExpr&>(expr));
+    case ExprKind::SET:
+      return Visit(static_cast<SetExpr&>(expr));
+    case ExprKind::THIS:
+      return Visit(static_cast<ThisExpr&>(expr));
+    case ExprKind::SUPER:
+      return Visit(static_cast<SuperExpr&>(expr));
+  }
+  return nullptr;
 }
 
-LoxObject Interpreter::Evaluate(ExprPtr& expr) { return expr->Accept(*this); }
+void Interpreter::CheckNumberOperand(const Token& op,
+                                     const LoxObject& operand) {
+  if (operand.is<double>()) {
+    return;
+  }
+  throw RuntimeError(op, "Operand must be a number.");
+}
 
-void Interpreter::CheckNumberOperands(Token op, LoxObject left,
-                                      LoxObject right) {
+void Interpreter::CheckNumberOperands(const Token& op, const LoxObject& left,
+                                      const LoxObject& right) {
   if (left.is<double>() && right.is<double>()) {
     return;
   }
   throw RuntimeError(op, "Operands must be numbers.");
 }
 
-void Interpreter::Execute(StmtPtr& stmt) { stmt->Accept(*this); }
+Completion Interpreter::Execute(const StmtPtr& stmt) {
+#ifdef LOX_SELECTABLE_DISPATCH
+  dispatched_nodes_++;
+  if (dispatch_ == Dispatch::VIRTUAL) {
+    return stmt->Accept(*this);
+  }
+#endif
+  switch (stmt->kind()) {
+    case StmtKind::BLOCK:
+      return Visit(static_cast<BlockStmt&>(*stmt));
+    case StmtKind::EXPRESSION:
+      return Visit(static_cast<ExprStmt&>(*stmt));
+    case StmtKind::PRINT:
+      return Visit(static_cast<PrintStmt&>(*stmt));
+    case StmtKind::VAR:
+      return Visit(static_cast<VarStmt&>(*stmt));
+    case StmtKind::IF:
+      return Visit(static_cast<IfStmt&>(*stmt));
+    case StmtKind::WHILE:
+      return Visit(static_cast<WhileStmt&>(*stmt));
+    case StmtKind::BREAK:
+      return Visit(static_cast<BreakStmt&>(*stmt));
+    case StmtKind::FUNCTION:
+      return Visit(static_cast<FunctionStmt&>(*stmt));
+    case StmtKind::RETURN:
+      return Visit(static_cast<ReturnStmt&>(*stmt));
+    case StmtKind::CLASS:
+      return Visit(static_cast<ClassStmt&>(*stmt));
+  }
+  return Completion::NORMAL;
+}
 
-void Interpreter::ExecuteBlock(std::vector<StmtPtr>& statements,
-                               std::shared_ptr<Environment> environment) {
-  std::shared_ptr<Environment> previous = environment_;
-  try {
-    environment_ = environment;
-    for (auto& statement : statements) {
-      Execute(statement);
+// 块不单独分配栈帧，块内变量就是当前栈帧中的槽位
+Completion Interpreter::ExecuteBlock(const std::vector<StmtPtr>& statements) {
+  for (auto& statement : statements) {
+    Completion completion = Execute(statement);
+    if (completion != Completion::NORMAL) {
+      return completion;
     }
-  } catch (...) {
-    environment_ = previous;
-    throw;
   }
-  environment_ = previous;
+  return Completion::NORMAL;
+}
+
+Completion Interpreter::ExecuteFunction(const FunctionStmt& function,
+                                        const Upvalues& upvalues,
+                                        const LoxObject* receiver,
+                                        size_t arguments) {
+  FrameScope frame(*this, arguments, arguments + function.frame_size_,
+                   &upvalues);
+  heap_.MaybeCollect();
+  if (receiver != nullptr) {
+    stack_.value(arguments + function.parameters_.size()) = *receiver;
+  }
+  // 被捕获的参数（及 this）搬进 Cell
+  for (int slot : function.captured_parameters_) {
+    LoxObject& value = stack_.value(arguments + slot);
+    stack_.cell(arguments + slot) = MakeRef<Cell>(std::move(value));
+  }
+  if (function.compiled_body_) {
+    return function.compiled_body_(*this);
+  }
+  return ExecuteBlock(function.body_);
 }
 
-void Interpreter::Resolve(const Expr& expression, int depth) {
-  locals_[&expression] = depth;
+LoxObject Interpreter::LookUpVariable(const Token& name,
+                                      const VariableRef& ref) {
+  switch (ref.kind) {
+    case VariableRef::Kind::LOCAL:
+      return stack_.value(fp_ + ref.slot);
+    case VariableRef::Kind::CELL:
+      return stack_.cell(fp_ + ref.slot)->value;
+    case VariableRef::Kind::UPVALUE:
+      return (*upvalues_)[ref.slot]->value;
+    case VariableRef::Kind::GLOBAL:
+      break;
+  }
+  return globals_.Get(ref.slot, name);
+}
+
+void Interpreter::AssignVariable(const Token& name, const VariableRef& ref,
+                                 LoxObject value) {
+  if (ref.kind == VariableRef::Kind::GLOBAL) {
+    globals_.Assign(ref.slot, name, value);
+  } else {
+    SetVariable(ref, std::move(value));
+  }
+}
+
+void Interpreter::DefineVariable(const VariableRef& ref, LoxObject value) {
+  if (ref.kind == VariableRef::Kind::CELL) {
+    stack_.cell(fp_ + ref.slot) = MakeRef<Cell>(std::move(value));
+  } else {
+    SetVariable(ref, std::move(value));
+  }
+}
+
+void Interpreter::SetVariable(const VariableRef& ref, LoxObject value) {
+  switch (ref.kind) {
+    case VariableRef::Kind::LOCAL:
+      stack_.value(fp_ + ref.slot) = std::move(value);
+      break;
+    case VariableRef::Kind::CELL:
+      stack_.cell(fp_ + ref.slot)->value = std::move(value);
+      break;
+    case VariableRef::Kind::UPVALUE:
+      (*upvalues_)[ref.slot]->value = std::move(value);
+      break;
+    case VariableRef::Kind::GLOBAL:
+      globals_.Define(ref.slot, value);
+      break;
+  }
 }
 
-LoxObject Interpreter::LookUpVariable(const Token& name, const Expr* expr) {
-  if (locals_.find(expr) != locals_.end()) {
-    int distance = locals_.at(expr);
-    return environment_->GetAt(name.lexeme(), distance);
+Upvalues Interpreter::CaptureUpvalues(const FunctionStmt& function) {
+  Upvalues upvalues;
+  upvalues.reserve(function.upvalues_.size());
+  for (const auto& upvalue : function.upvalues_) {
+    upvalues.push_back(upvalue.is_local ? stack_.cell(fp_ + upvalue.index)
+                                        : (*upvalues_)[upvalue.index]);
   }
-  return global_env_->Get(name);
+  return upvalues;
 }
 
-}  // namespace lox
\ No newline at end of file
+}  // namespace lox
@@ -5,24 +5,74 @@
 #include "lox_interpreter/ast/expr.h"
 #include "lox_interpreter/ast/stmt.h"
 #include "lox_interpreter/util/lox_object.h"
-#include "lox_interpreter/core/environment.h"
-
+#include "lox_interpreter/core/call_stack.h"
+#include "lox_interpreter/core/globals.h"
+#include "lox_interpreter/core/heap.h"
+#include "lox_interpreter/core/output.h"
+#include "lox_interpreter/core/pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace lox {
 
 // 前向声明
 class FunctionCallable;
-class Resolver;
+class LoxCallable;
+class ClosureCompiler;
+
+// 执行后端：直接遍历 AST，或先把 AST 编译成闭包树（见 ClosureCompiler）
+enum class Backend {
+  AST,
+  CLOSURE,
+};
+
+// 节点派发方式：按节点种类 switch，或走 Accept 的虚调用（用于对比）。
+//
+// 只有定义了 LOX_SELECTABLE_DISPATCH 的构建（测试和基准测试）才能切换；
+// 发布的解释器只编译 switch，每个节点不必先检查一次派发方式
+enum class Dispatch {
+  SWITCH,
+  VIRTUAL,
+};
 
-class Interpreter : public ExprVisitor, public StmtVisitor {
+// 声明为 final，Evaluate/Execute 中对 Visit 的调用都是直接调用
+class Interpreter final : public ExprVisitor, public StmtVisitor {
   friend class FunctionCallable;
-  friend class Resolver;
+  friend class ClosureCompiler;
 
  public:
   Interpreter();
 
-  void Interpret(std::vector<StmtPtr> statements);
+  void set_backend(Backend backend) { backend_ = backend; }
+#ifdef LOX_SELECTABLE_DISPATCH
+  void set_dispatch(Dispatch dispatch) { dispatch_ = dispatch; }
+
+  // 经 Evaluate/Execute 派发过的节点数，基准测试按它折算每个节点的开销
+  uint64_t dispatched_nodes() const { return dispatched_nodes_; }
+#endif
+
+  // arena 为语法树节点所在的 arena。传入时由解释器接管，与语法树一起保存；
+  // 为空表示 arena 由调用方保证比解释器活得久
+  void Interpret(std::vector<StmtPtr> statements,
+                 std::unique_ptr<AstArena> arena = nullptr);
+
+  // 写出 print 缓冲的输出。Interpret 返回前已经调用过
+  void FlushOutput() { output_.Flush(); }
+
+  // 运行时对象所在的池。Lox 在解析前就把它设为当前池，让语法树里的
+  // 常量也从这里分配；--mem-stats 读取它的统计
+  ObjectPool& pool() const { return *pool_; }
+
+  // 供 Resolver 为全局名字分配（或查询）全局变量表下标
+  int GlobalSlot(const Token& name) { return globals_.Slot(name.symbol()); }
+
+  // 供 Resolver 登记顶层代码（块中的局部变量）需要的栈帧大小
+  void ReserveTopLevelSlots(int count) {
+    top_level_slots_ = std::max(top_level_slots_, static_cast<size_t>(count));
+  }
 
   LoxObject Visit(LiteralExpr& expr) override;
 
@@ -48,43 +98,152 @@ class Interpreter : public ExprVisitor, public StmtVisitor {
 
   LoxObject Visit(SuperExpr& super_expr) override;
 
-  void Visit(BlockStmt& block_stmt) override;
+  Completion Visit(BlockStmt& block_stmt) override;
 
-  void Visit(ExprStmt& expr_stmt) override;
+  Completion Visit(ExprStmt& expr_stmt) override;
 
-  void Visit(PrintStmt& print_stmt) override;
+  Completion Visit(PrintStmt& print_stmt) override;
 
-  void Visit(VarStmt& var_stmt) override;
+  Completion Visit(VarStmt& var_stmt) override;
 
-  void Visit(IfStmt& if_stmt) override;
+  Completion Visit(IfStmt& if_stmt) override;
 
-  void Visit(WhileStmt& while_stmt) override;
+  Completion Visit(WhileStmt& while_stmt) override;
 
-  void Visit(BreakStmt& break_stmt) override;
+  Completion Visit(BreakStmt& break_stmt) override;
 
-  void Visit(FunctionStmt& function_stmt) override;
+  Completion Visit(FunctionStmt& function_stmt) override;
 
-  void Visit(ReturnStmt& return_stmt) override;
+  Completion Visit(ReturnStmt& return_stmt) override;
 
-  void Visit(ClassStmt& class_stmt) override;
+  Completion Visit(ClassStmt& class_stmt) override;
 
  private:
   LoxObject Evaluate(ExprPtr& expr);
-
-  void CheckNumberOperands(Token op, LoxObject left, LoxObject right);
-
-  void Execute(StmtPtr& stmt);
-
-  void ExecuteBlock(std::vector<StmtPtr>& statements,
-                    std::shared_ptr<Environment> environment);
-
-  void Resolve(const Expr& expression, int depth);
-
-  LoxObject LookUpVariable(const Token& name, const Expr* expr);
-
-  std::shared_ptr<Environment> global_env_;
-  std::shared_ptr<Environment> environment_;
-  std::unordered_map<const Expr*, int> locals_;
+  LoxObject Evaluate(Expr& expr);
+
+  LoxObject CallMethod(CallExpr& call);
+
+  LoxObject CallValue(CallExpr& call, const LoxObject& callee);
+
+  // 求值实参并依次压到值栈顶，返回第一个实参所在的槽位
+  size_t PushArguments(std::vector<ExprPtr>& arguments);
+
+  void PushArgument(LoxObject value) {
+    stack_.Reserve(sp_ + 1);
+    stack_.value(sp_++) = std::move(value);
+  }
+
+  // 调用 callee，实参已压在 arguments 开始的槽位上；返回后弹出实参
+  LoxObject CallCallable(const CallExpr& call, const LoxObject& callee,
+                         size_t arguments);
+
+  void CheckArity(const CallExpr& call, LoxCallable& callable,
+                  size_t argument_count);
+
+  LoxObject GetProperty(GetExpr& expr, const LoxObject& object);
+
+  // BinaryExpr 的各个特化版本，见 Specialization
+  static Specialization Specialize(TokenType op, const LoxObject& left,
+                                   const LoxObject& right);
+  LoxObject NumberBinary(const BinaryExpr& expr, double left, double right);
+  LoxObject StringBinary(const BinaryExpr& expr, const LoxString& left,
+                         const LoxString& right);
+  LoxObject GenericBinary(const BinaryExpr& expr, const LoxObject& left,
+                          const LoxObject& right);
+
+  void CheckNumberOperand(const Token& op, const LoxObject& operand);
+  void CheckNumberOperands(const Token& op, const LoxObject& left,
+                           const LoxObject& right);
+
+  Completion Execute(const StmtPtr& stmt);
+
+  Completion ExecuteBlock(const std::vector<StmtPtr>& statements);
+
+  // 在 arguments 处开一个新栈帧执行函数体。receiver 非空时作为 this
+  // 写在参数之后
+  Completion ExecuteFunction(const FunctionStmt& function,
+                             const Upvalues& upvalues,
+                             const LoxObject* receiver, size_t arguments);
+
+  // 切换到新栈帧，析构时清空栈帧并恢复调用方的栈帧。只有 RuntimeError
+  // 仍以异常形式穿过这里，正常路径上没有 try/catch
+  class FrameScope {
+   public:
+    FrameScope(Interpreter& interpreter, size_t base, size_t top,
+               const Upvalues* upvalues)
+        : interpreter_(interpreter),
+          fp_(interpreter.fp_),
+          sp_(interpreter.sp_),
+          upvalues_(interpreter.upvalues_),
+          base_(base),
+          top_(top) {
+      interpreter_.stack_.Reserve(top);
+      interpreter_.fp_ = base;
+      interpreter_.sp_ = top;
+      interpreter_.upvalues_ = upvalues;
+    }
+    ~FrameScope() {
+      interpreter_.stack_.Clear(base_, top_);
+      interpreter_.fp_ = fp_;
+      interpreter_.sp_ = sp_;
+      interpreter_.upvalues_ = upvalues_;
+    }
+
+   private:
+    Interpreter& interpreter_;
+    size_t fp_;
+    size_t sp_;
+    const Upvalues* upvalues_;
+    size_t base_;
+    size_t top_;
+  };
+
+  // 按 Resolver 写在节点上的解析结果读写变量
+  LoxObject LookUpVariable(const Token& name, const VariableRef& ref);
+  void AssignVariable(const Token& name, const VariableRef& ref,
+                      LoxObject value);
+
+  // 写入声明语句所声明的变量；CELL 变量每次声明都新建一个 Cell，
+  // 因此循环体中的闭包各自捕获自己那一次迭代的变量
+  void DefineVariable(const VariableRef& ref, LoxObject value);
+
+  // 写入已经定义过的变量（不新建 Cell）
+  void SetVariable(const VariableRef& ref, LoxObject value);
+
+  // 在当前栈帧中创建 function 的闭包所需的 upvalue
+  Upvalues CaptureUpvalues(const FunctionStmt& function);
+
+  // 执行期间创建的运行时对象都从这里分配。最先声明、最后析构，
+  // 其余成员持有的对象释放时池还在
+  ObjectPool::Handle pool_ = ObjectPool::Create();
+  Globals globals_;
+  // 局部变量所在的值栈。fp_ 是当前栈帧的起点，sp_ 是栈帧之上第一个空闲
+  // 槽位（压实参从这里开始），upvalues_ 是当前执行的函数捕获的变量
+  CallStack stack_;
+  size_t fp_ = 0;
+  size_t sp_ = 0;
+  const Upvalues* upvalues_ = nullptr;
+  size_t top_level_slots_ = 0;
+  // 环回收的安全点：循环回边、函数入口和顶层语句之间
+  Heap& heap_ = Heap::Instance();
+  // 最近一次 return 的返回值，由 FunctionCallable 在收到 RETURN 时取走
+  LoxObject return_value_;
+  // print 语句的输出先攒在这里，见 OutputBuffer
+  OutputBuffer output_;
+  // 已执行过的程序。节点上保存着解析结果，函数对象也直接引用其声明，
+  // 因此 AST 必须和解释器活得一样久（REPL 中每行输入一份）
+  struct Program {
+    std::unique_ptr<AstArena> arena;
+    // 声明在 arena 之后，先于 arena 析构
+    std::vector<StmtPtr> statements;
+  };
+  std::vector<Program> programs_;
+  Backend backend_ = Backend::AST;
+#ifdef LOX_SELECTABLE_DISPATCH
+  Dispatch dispatch_ = Dispatch::SWITCH;
+  uint64_t dispatched_nodes_ = 0;
+#endif
 };
 
 }  // namespace lox
@@ -0,0 +1,257 @@
+#include "lox_interpreter/ast/visitors/optimizer.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lox {
+
+void Optimizer::Optimize(std::vector<StmtPtr>& statements) {
+  for (auto& statement : statements) {
+    Optimize(statement);
+  }
+  statements.erase(std::remove(statements.begin(), statements.end(), nullptr),
+                   statements.end());
+}
+
+void Optimizer::Optimize(ExprPtr& expr) {
+  expr->Accept(*this);
+  if (expr_replacement_ != nullptr) {
+    expr = std::move(expr_replacement_);
+  }
+}
+
+void Optimizer::Optimize(StmtPtr& stmt) {
+  stmt->Accept(*this);
+  if (remove_stmt_) {
+    remove_stmt_ = false;
+    stmt = nullptr;
+  } else if (stmt_replacement_ != nullptr) {
+    stmt = std::move(stmt_replacement_);
+  }
+}
+
+void Optimizer::OptimizeBranch(StmtPtr& stmt) {
+  Optimize(stmt);
+  if (stmt == nullptr) {
+    stmt = arena_.New<BlockStmt>(std::vector<StmtPtr>());
+  }
+}
+
+void Optimizer::Fold(LoxObject value) {
+  expr_replacement_ = arena_.New<LiteralExpr>(std::move(value));
+}
+
+LoxObject Optimizer::Visit(LiteralExpr& expr) {
+  (void)expr;  // 未使用参数
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(GroupingExpr& expr) {
+  Optimize(expr.expression_);
+  expr_replacement_ = std::move(expr.expression_);
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(UnaryExpr& expr) {
+  Optimize(expr.right_);
+  if (!IsLiteral(expr.right_)) {
+    return nullptr;
+  }
+  const LoxObject& right = LiteralValue(expr.right_);
+  if (expr.op_.type() == TokenType::BANG) {
+    Fold(!right.isTruthy());
+  } else if (expr.op_.type() == TokenType::MINUS && right.is<double>()) {
+    Fold(-right.asNumber());
+  }
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(BinaryExpr& expr) {
+  Optimize(expr.left_);
+  Optimize(expr.right_);
+  if (!IsLiteral(expr.left_) || !IsLiteral(expr.right_)) {
+    return nullptr;
+  }
+
+  const LoxObject& left = LiteralValue(expr.left_);
+  const LoxObject& right = LiteralValue(expr.right_);
+  TokenType op = expr.op_.type();
+  if (op == TokenType::EQUAL_EQUAL) {
+    Fold(left == right);
+  } else if (op == TokenType::BANG_EQUAL) {
+    Fold(left != right);
+  } else if (left.is<double>() && right.is<double>()) {
+    double a = left.asNumber();
+    double b = right.asNumber();
+    switch (op) {
+      case TokenType::PLUS:
+        Fold(a + b);
+        break;
+      case TokenType::MINUS:
+        Fold(a - b);
+        break;
+      case TokenType::STAR:
+        Fold(a * b);
+        break;
+      case TokenType::SLASH:
+        // 除零留到运行时报错
+        if (b != 0) {
+          Fold(a / b);
+        }
+        break;
+      case TokenType::GREATER:
+        Fold(a > b);
+        break;
+      case TokenType::GREATER_EQUAL:
+        Fold(a >= b);
+        break;
+      case TokenType::LESS:
+        Fold(a < b);
+        break;
+      case TokenType::LESS_EQUAL:
+        Fold(a <= b);
+        break;
+      default:
+        break;
+    }
+  } else if (op == TokenType::PLUS && left.is<std::string>() &&
+             right.is<std::string>()) {
+    Fold(left.get<std::string>() + right.get<std::string>());
+  }
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(VariableExpr& variable) {
+  (void)variable;  // 未使用参数
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(AssignExpr& assign) {
+  Optimize(assign.value_);
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(LogicalExpr& logical) {
+  Optimize(logical.left_);
+  Optimize(logical.right_);
+  if (!IsLiteral(logical.left_)) {
+    return nullptr;
+  }
+  // and：左边为假时结果就是左边，否则是右边；or 反之
+  bool left_decides = LiteralValue(logical.left_).isTruthy() ==
+                      (logical.op_.type() == TokenType::OR);
+  expr_replacement_ =
+      left_decides ? std::move(logical.left_) : std::move(logical.right_);
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(CallExpr& call) {
+  Optimize(call.callee_);
+  for (auto& argument : call.arguments_) {
+    Optimize(argument);
+  }
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(GetExpr& get) {
+  Optimize(get.object_);
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(SetExpr& set) {
+  Optimize(set.object_);
+  Optimize(set.value_);
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(ThisExpr& this_expr) {
+  (void)this_expr;  // 未使用参数
+  return nullptr;
+}
+
+LoxObject Optimizer::Visit(SuperExpr& super_expr) {
+  (void)super_expr;  // 未使用参数
+  return nullptr;
+}
+
+Completion Optimizer::Visit(BlockStmt& block_stmt) {
+  Optimize(block_stmt.statements_);
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(ExprStmt& expr_stmt) {
+  Optimize(expr_stmt.expr_);
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(PrintStmt& print_stmt) {
+  Optimize(print_stmt.expr_);
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(VarStmt& var_stmt) {
+  if (var_stmt.initializer_ != nullptr) {
+    Optimize(var_stmt.initializer_);
+  }
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(IfStmt& if_stmt) {
+  Optimize(if_stmt.condition_);
+  OptimizeBranch(if_stmt.then_branch_);
+  if (if_stmt.else_branch_ != nullptr) {
+    OptimizeBranch(if_stmt.else_branch_);
+  }
+  if (!IsLiteral(if_stmt.condition_)) {
+    return Completion::NORMAL;
+  }
+
+  // 分支不是声明语句，换到 if 的位置上不影响 Resolver 分配的槽位
+  if (LiteralValue(if_stmt.condition_).isTruthy()) {
+    stmt_replacement_ = std::move(if_stmt.then_branch_);
+  } else if (if_stmt.else_branch_ != nullptr) {
+    stmt_replacement_ = std::move(if_stmt.else_branch_);
+  } else {
+    remove_stmt_ = true;
+  }
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(WhileStmt& while_stmt) {
+  Optimize(while_stmt.condition_);
+  if (IsLiteral(while_stmt.condition_) &&
+      !LiteralValue(while_stmt.condition_).isTruthy()) {
+    remove_stmt_ = true;
+    return Completion::NORMAL;
+  }
+  OptimizeBranch(while_stmt.body_);
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(BreakStmt& break_stmt) {
+  (void)break_stmt;  // 未使用参数
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(FunctionStmt& function_stmt) {
+  Optimize(function_stmt.body_);
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(ReturnStmt& return_stmt) {
+  if (return_stmt.value_ != nullptr) {
+    Optimize(return_stmt.value_);
+  }
+  return Completion::NORMAL;
+}
+
+Completion Optimizer::Visit(ClassStmt& class_stmt) {
+  for (auto& method : class_stmt.methods_) {
+    Optimize(method.body_);
+  }
+  return Completion::NORMAL;
+}
+
+}  // namespace lox
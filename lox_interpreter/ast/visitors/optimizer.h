@@ -0,0 +1,80 @@
+#ifndef LOX_AST_VISITORS_OPTIMIZER_H_
+#define LOX_AST_VISITORS_OPTIMIZER_H_
+
+#include <vector>
+
+#include "lox_interpreter/ast/arena.h"
+#include "lox_interpreter/ast/visitor.h"
+#include "lox_interpreter/ast/expr.h"
+#include "lox_interpreter/ast/stmt.h"
+
+namespace lox {
+
+// AST 级优化（lox_interpreter -O），在 Resolver 之后、执行之前运行：
+//   - 去掉所有 GroupingExpr 包装
+//   - 折叠字面量之间的算术、比较、相等判断和字符串拼接，以及一元运算
+//   - 左操作数是字面量的 and / or 直接选定结果
+//   - 条件为常量的 if 只保留会执行的分支，条件恒假的 while 整个删除
+// 运行时会报错的表达式（除零、类型不符）保持原样，错误照常在运行时报告。
+//
+// 访问者的返回值类型是固定的，节点的替换结果通过 expr_replacement_ /
+// stmt_replacement_ 传回父节点；新节点从语法树所在的 arena 分配。
+class Optimizer : public ExprVisitor, public StmtVisitor {
+ public:
+  explicit Optimizer(AstArena& arena) : arena_(arena) {}
+
+  void Optimize(std::vector<StmtPtr>& statements);
+
+  LoxObject Visit(LiteralExpr& expr) override;
+  LoxObject Visit(GroupingExpr& expr) override;
+  LoxObject Visit(UnaryExpr& expr) override;
+  LoxObject Visit(BinaryExpr& expr) override;
+  LoxObject Visit(VariableExpr& variable) override;
+  LoxObject Visit(AssignExpr& assign) override;
+  LoxObject Visit(LogicalExpr& logical) override;
+  LoxObject Visit(CallExpr& call) override;
+  LoxObject Visit(GetExpr& get) override;
+  LoxObject Visit(SetExpr& set) override;
+  LoxObject Visit(ThisExpr& this_expr) override;
+  LoxObject Visit(SuperExpr& super_expr) override;
+
+  Completion Visit(BlockStmt& block_stmt) override;
+  Completion Visit(ExprStmt& expr_stmt) override;
+  Completion Visit(PrintStmt& print_stmt) override;
+  Completion Visit(VarStmt& var_stmt) override;
+  Completion Visit(IfStmt& if_stmt) override;
+  Completion Visit(WhileStmt& while_stmt) override;
+  Completion Visit(BreakStmt& break_stmt) override;
+  Completion Visit(FunctionStmt& function_stmt) override;
+  Completion Visit(ReturnStmt& return_stmt) override;
+  Completion Visit(ClassStmt& class_stmt) override;
+
+ private:
+  void Optimize(ExprPtr& expr);
+
+  // 语句被整个删除时 stmt 变为 nullptr
+  void Optimize(StmtPtr& stmt);
+
+  // if 分支、循环体等只能放一条语句的位置，被删除的语句换成空块
+  void OptimizeBranch(StmtPtr& stmt);
+
+  static bool IsLiteral(const ExprPtr& expr) {
+    return expr->kind() == ExprKind::LITERAL;
+  }
+
+  static const LoxObject& LiteralValue(const ExprPtr& expr) {
+    return static_cast<const LiteralExpr&>(*expr).value_;
+  }
+
+  // 用值为 value 的字面量替换当前表达式
+  void Fold(LoxObject value);
+
+  AstArena& arena_;
+  ExprPtr expr_replacement_;
+  StmtPtr stmt_replacement_;
+  bool remove_stmt_ = false;
+};
+
+}  // namespace lox
+
+#endif  // LOX_AST_VISITORS_OPTIMIZER_H_
@@ -2,6 +2,7 @@
 #define LOX_AST_VISITORS_PRINTER_H_
 
 #include <string>
+#include <string_view>
 #include <initializer_list>
 
 #include "lox_interpreter/ast/visitor.h"
@@ -79,9 +80,10 @@ class Printer : public ExprVisitor {
   }
 
  private:
-  void Parenthesize(const std::string& name,
+  void Parenthesize(std::string_view name,
                     std::initializer_list<Expr*> exprs) {
-    result_ += "(" + name;
+    result_ += "(";
+    result_ += name;
     for (Expr* expr : exprs) {
       result_ += " ";
       expr->Accept(*this);
@@ -0,0 +1,81 @@
+#ifndef LOX_CORE_CALL_STACK_H_
+#define LOX_CORE_CALL_STACK_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "lox_interpreter/core/heap.h"
+#include "lox_interpreter/core/pool.h"
+#include "lox_interpreter/util/lox_object.h"
+#include "lox_interpreter/util/ref.h"
+
+namespace lox {
+
+// 被闭包捕获的局部变量提升到堆上的单元。声明它的栈帧和捕获它的闭包
+// 共享同一个 Cell，因此栈帧返回后闭包仍能读写这个变量
+class Cell : public Collectable {
+ public:
+  explicit Cell(LoxObject value) : value(std::move(value)) {}
+
+  void Trace(std::vector<Collectable*>& children) const override {
+    Heap::Trace(value, children);
+  }
+
+  void ClearReferences() override { value = nullptr; }
+
+  LoxObject value;
+};
+
+// 闭包捕获的外层变量，下标即 Resolver 分配的 upvalue 编号
+using Upvalues = std::vector<Ref<Cell>, PoolAllocator<Ref<Cell>>>;
+
+// 局部变量所在的连续值栈。
+//
+// 每次调用在栈顶占用一段固定大小的栈帧，大小由 Resolver 按函数内同时
+// 存活的局部变量数算出；参数由调用方直接依次写在新栈帧的开头。块作用域
+// 不单独分配，块内变量就是所在函数栈帧中的槽位，兄弟块复用同一批槽位。
+//
+// 未被捕获的变量直接存在 values_ 中；被捕获的变量存在 cells_ 的同一下标处，
+// 两个数组始终等长。扩容会移动已有元素，因此不能跨越求值持有槽位的引用。
+class CallStack {
+ public:
+  CallStack() { Grow(kInitialSlots); }
+
+  // 保证 [0, top) 的槽位可用
+  void Reserve(size_t top) {
+    if (top > values_.size()) {
+      Grow(top);
+    }
+  }
+
+  size_t size() const { return values_.size(); }
+
+  LoxObject& value(size_t index) { return values_[index]; }
+  Ref<Cell>& cell(size_t index) { return cells_[index]; }
+
+  // 栈帧返回时释放其中的值，避免栈上残留的引用让对象活得过久
+  void Clear(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      values_[i] = nullptr;
+      cells_[i] = nullptr;
+    }
+  }
+
+ private:
+  static constexpr size_t kInitialSlots = 4096;
+
+  void Grow(size_t top) {
+    size_t size = std::max(top, values_.size() * 2);
+    values_.resize(size);
+    cells_.resize(size);
+  }
+
+  std::vector<LoxObject> values_;
+  std::vector<Ref<Cell>> cells_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_CALL_STACK_H_
@@ -0,0 +1,66 @@
+#ifndef LOX_CORE_GLOBALS_H_
+#define LOX_CORE_GLOBALS_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "lox_interpreter/core/symbol.h"
+#include "lox_interpreter/core/token.h"
+#include "lox_interpreter/util/lox_object.h"
+#include "lox_interpreter/util/runtime_error.h"
+
+namespace lox {
+
+// 全局变量表。Resolver 在第一次遇到某个全局名字时（无论是定义还是引用）
+// 为它分配一个固定下标并写到 AST 节点上，运行时只按下标访问，不再哈希名字。
+// 先引用、后定义的名字同样先占一个下标，读取时若尚未定义才报错。
+class Globals {
+ public:
+  // 返回名字对应的下标，必要时分配新下标
+  int Slot(Symbol name) {
+    auto it = slots_.find(name);
+    if (it != slots_.end()) {
+      return it->second;
+    }
+    int slot = static_cast<int>(values_.size());
+    slots_.emplace(name, slot);
+    values_.emplace_back();
+    return slot;
+  }
+
+  void Define(int slot, const LoxObject& value) {
+    values_[slot].value = value;
+    values_[slot].defined = true;
+  }
+
+  const LoxObject& Get(int slot, const Token& name) const {
+    const Global& global = values_[slot];
+    if (!global.defined) {
+      throw RuntimeError(
+          name, "Undefined variable '" + std::string(name.lexeme()) + "'.");
+    }
+    return global.value;
+  }
+
+  void Assign(int slot, const Token& name, const LoxObject& value) {
+    Global& global = values_[slot];
+    if (!global.defined) {
+      throw RuntimeError(
+          name, "Undefined variable '" + std::string(name.lexeme()) + "'.");
+    }
+    global.value = value;
+  }
+
+ private:
+  struct Global {
+    LoxObject value;
+    bool defined = false;
+  };
+
+  std::unordered_map<Symbol, int> slots_;
+  std::vector<Global> values_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_GLOBALS_H_
@@ -0,0 +1,88 @@
+#include "lox_interpreter/core/heap.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "lox_interpreter/util/lox_callable.h"
+#include "lox_interpreter/util/lox_class.h"
+#include "lox_interpreter/util/lox_instance.h"
+
+namespace lox {
+
+void Heap::Trace(const LoxObject& value, std::vector<Collectable*>& children) {
+  switch (value.index()) {
+    case TypeIndex::INSTANCE:
+    case TypeIndex::CLASS:
+      children.push_back(&value.get<LoxInstance>());
+      break;
+    case TypeIndex::CALLABLE:
+      children.push_back(&value.get<CallableObject>());
+      break;
+    default:
+      break;
+  }
+}
+
+size_t Heap::Collect() {
+  std::vector<Collectable*> objects;
+  objects.reserve(size_);
+  for (Collectable* object = head_; object != nullptr; object = object->next_) {
+    objects.push_back(object);
+  }
+
+  // 引用计数减去内部引用，剩下的是外部引用。还没交给 Ref 的对象
+  // （计数为 0）不会被别的对象引用，按 1 个外部引用算作根
+  for (Collectable* object : objects) {
+    object->gc_refs_ = std::max<long>(object->ref_count(), 1);
+    object->gc_reachable_ = false;
+  }
+  std::vector<Collectable*> children;
+  for (Collectable* object : objects) {
+    children.clear();
+    object->Trace(children);
+    for (Collectable* child : children) {
+      child->gc_refs_--;
+    }
+  }
+
+  // 从有外部引用的对象出发标记
+  std::vector<Collectable*> pending;
+  for (Collectable* object : objects) {
+    if (object->gc_refs_ > 0) {
+      object->gc_reachable_ = true;
+      pending.push_back(object);
+    }
+  }
+  while (!pending.empty()) {
+    Collectable* object = pending.back();
+    pending.pop_back();
+    children.clear();
+    object->Trace(children);
+    for (Collectable* child : children) {
+      if (!child->gc_reachable_) {
+        child->gc_reachable_ = true;
+        pending.push_back(child);
+      }
+    }
+  }
+
+  // 先持有全部垃圾再断开引用，避免拆环途中有垃圾对象被提前析构
+  std::vector<Ref<Collectable>> garbage;
+  for (Collectable* object : objects) {
+    if (!object->gc_reachable_) {
+      garbage.emplace_back(object);
+    }
+  }
+  for (auto& object : garbage) {
+    object->ClearReferences();
+  }
+  size_t freed = garbage.size();
+  garbage.clear();
+
+  stats_.collections++;
+  stats_.freed += freed;
+  next_collection_ = std::max(kMinThreshold, size_ * 2);
+  return freed;
+}
+
+}  // namespace lox
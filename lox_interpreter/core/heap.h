@@ -0,0 +1,128 @@
+#ifndef LOX_CORE_HEAP_H_
+#define LOX_CORE_HEAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "lox_interpreter/util/lox_object.h"
+#include "lox_interpreter/util/ref.h"
+
+namespace lox {
+
+class Collectable;
+
+// 运行时对象之间的环回收。
+//
+// 对象的生命周期仍由引用计数（RefCounted）管理，引用计数处理不了的环
+// （闭包通过 Cell 引用自己、实例之间互相引用、方法捕获所在的类……）
+// 由这里定期回收，做法是在引用计数之上做 trial deletion：
+//   1. 每个对象的引用计数减去来自其他 Collectable 的引用数，剩下的
+//      就是来自值栈、全局变量表、C++ 局部变量等外部的引用
+//   2. 仍有外部引用的对象是根，从根出发标记所有可达对象
+//   3. 不可达的对象只被垃圾引用，断开它们持有的引用，环随之释放
+// 外部引用不需要登记，因此任何一个安全点都可以回收；唯一的要求是每个
+// Collectable 的 Trace 不多不少地列出它持有的引用。
+//
+// 进程内只有一个 Heap，所有 Collectable 构造时登记、析构时注销。
+class Heap {
+ public:
+  struct Stats {
+    uint64_t collections = 0;
+    uint64_t freed = 0;
+    // 同时存活的 Collectable 数的峰值
+    size_t peak = 0;
+  };
+
+  // 有意不析构：静态对象析构顺序不确定，退出时仍可能有对象注销
+  static Heap& Instance() {
+    static Heap* heap = new Heap();
+    return *heap;
+  }
+
+  size_t size() const { return size_; }
+  Stats& stats() { return stats_; }
+
+  // 由解释器在安全点（循环回边、函数入口、顶层语句之间）调用。
+  // 自上次回收以来存活对象数翻倍才真正回收，摊还代价与分配量成正比
+  void MaybeCollect() {
+    if (size_ >= next_collection_) {
+      Collect();
+    }
+  }
+
+  // 回收所有不可达的环，返回释放的对象数
+  size_t Collect();
+
+  // value 引用的是 Collectable 时追加到 children
+  static void Trace(const LoxObject& value,
+                    std::vector<Collectable*>& children);
+
+ private:
+  friend class Collectable;
+
+  static constexpr size_t kMinThreshold = 1 << 14;
+
+  Heap() = default;
+
+  void Register(Collectable* object);
+  void Unregister(Collectable* object);
+
+  // 所有存活的 Collectable 串成一条侵入式双向链表
+  Collectable* head_ = nullptr;
+  size_t size_ = 0;
+  size_t next_collection_ = kMinThreshold;
+  Stats stats_;
+};
+
+// 可能参与环的运行时对象（Cell、FunctionCallable、LoxInstance/LoxClass）
+// 的基类。必须由 Ref 持有
+class Collectable : public RefCounted {
+ public:
+  Collectable() { Heap::Instance().Register(this); }
+  ~Collectable() override { Heap::Instance().Unregister(this); }
+
+  // 把直接持有的 Collectable 追加到 children，每持有一个引用
+  // （Ref 或者 LoxObject）就追加一次
+  virtual void Trace(std::vector<Collectable*>& children) const = 0;
+
+  // 释放持有的引用，用来拆开垃圾环
+  virtual void ClearReferences() = 0;
+
+ private:
+  friend class Heap;
+
+  Collectable* prev_ = nullptr;
+  Collectable* next_ = nullptr;
+  // 回收过程中使用：外部引用数、是否可达
+  long gc_refs_ = 0;
+  bool gc_reachable_ = false;
+};
+
+inline void Heap::Register(Collectable* object) {
+  object->next_ = head_;
+  if (head_ != nullptr) {
+    head_->prev_ = object;
+  }
+  head_ = object;
+  size_++;
+  if (size_ > stats_.peak) {
+    stats_.peak = size_;
+  }
+}
+
+inline void Heap::Unregister(Collectable* object) {
+  if (object->prev_ != nullptr) {
+    object->prev_->next_ = object->next_;
+  } else {
+    head_ = object->next_;
+  }
+  if (object->next_ != nullptr) {
+    object->next_->prev_ = object->prev_;
+  }
+  size_--;
+}
+
+}  // namespace lox
+
+#endif  // LOX_CORE_HEAP_H_
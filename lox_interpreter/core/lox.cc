@@ -1,7 +1,7 @@
-#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
-#include <iterator>
+#include <memory>
 #include <cstdlib>
 #include <vector>
 
@@ -12,14 +12,37 @@
 #include "lox_interpreter/core/parser.h"
 #include "lox_interpreter/core/resolver.h"
 #include "lox_interpreter/ast/visitors/interpreter.h"
+#include "lox_interpreter/ast/visitors/optimizer.h"
+#include "lox_interpreter/util/inline_cache.h"
+#include "lox_interpreter/core/heap.h"
+#include "lox_interpreter/core/pool.h"
 
 namespace lox {
 
+namespace {
+
+// 整个进程共用一个解释器，REPL 的每行输入看到同样的全局变量
+Interpreter& SharedInterpreter() {
+  static Interpreter interpreter;
+  return interpreter;
+}
+
+}  // namespace
+
 void Lox::RunFile(const std::string& path) {
-  std::ifstream file(path);
-  std::string content((std::istreambuf_iterator<char>(file)),
-                      std::istreambuf_iterator<char>());
-  run(content);
+  // 大文件直接映射，Scanner 在映射的页上扫描，不复制文件内容
+  Source source;
+  if (!Source::Load(path, &source)) {
+    std::cerr << "Could not read file '" << path << "'." << std::endl;
+    exit(66);
+  }
+  run(std::move(source));
+  if (print_cache_stats_) {
+    PrintCacheStats();
+  }
+  if (print_memory_stats_) {
+    PrintMemoryStats();
+  }
   if (has_error_) {
     exit(65);
   }
@@ -32,22 +55,27 @@ void Lox::RunPrompt() {
   std::string line;
   std::cout << "> ";
   while (std::getline(std::cin, line)) {
-    run(line);
+    run(Source(line));
     has_error_ = false;
     std::cout << "> ";
   }
 }
 
-void Lox::run(const std::string& source) {
-  Scanner scanner(source);
-  std::vector<Token> tokens = scanner.ScanTokens();
-  Parser parser(tokens);
+void Lox::run(Source source) {
+  Interpreter& interpreter = SharedInterpreter();
+  // 解析和优化时创建的常量（字符串字面量、折叠结果）也放进解释器的池
+  ObjectPool::Scope pool_scope(interpreter.pool());
+
+  // 语法树中的 token 引用源码，源码随 arena 一起交给解释器保存
+  auto arena = std::make_unique<AstArena>();
+  Scanner scanner(arena->AdoptSource(std::move(source)));
+  Parser parser(scanner, *arena);
   std::vector<StmtPtr> statements = parser.Parse();
   if (has_error_) {
     return;
   }
 
-  static Interpreter interpreter;
+  interpreter.set_backend(backend_);
 
   Resolver resolver(interpreter);
   resolver.Resolve(statements);
@@ -55,7 +83,56 @@ void Lox::run(const std::string& source) {
     return;
   }
 
-  interpreter.Interpret(std::move(statements));
+  if (optimize_) {
+    Optimizer optimizer(*arena);
+    optimizer.Optimize(statements);
+  }
+
+  interpreter.Interpret(std::move(statements), std::move(arena));
+}
+
+void Lox::PrintCacheStats() const {
+  PropertyCache::Stats stats = PropertyCache::CollectStats();
+  uint64_t total = stats.hits + stats.misses;
+  double hit_rate = total == 0 ? 0.0 : 100.0 * stats.hits / total;
+  std::cerr << "[ic] property accesses: " << total << ", hits: " << stats.hits
+            << ", misses: " << stats.misses << " (" << hit_rate
+            << "% hit), megamorphic sites: " << stats.megamorphic_sites
+            << std::endl;
+}
+
+void Lox::PrintMemoryStats() const {
+  const ObjectPool& pool = SharedInterpreter().pool();
+  uint64_t allocations = 0;
+  uint64_t system_allocations = 0;
+  std::cerr << "[mem] " << std::setw(6) << "size" << std::setw(12) << "allocs"
+            << std::setw(12) << "frees" << std::setw(10) << "live"
+            << std::setw(10) << "peak" << std::setw(8) << "slabs" << std::endl;
+  auto print_row = [&](const std::string& name,
+                       const ObjectPool::Stats& stats) {
+    allocations += stats.allocations;
+    system_allocations += stats.slabs;
+    if (stats.allocations == 0) {
+      return;
+    }
+    std::cerr << "[mem] " << std::setw(6) << name << std::setw(12)
+              << stats.allocations << std::setw(12) << stats.frees
+              << std::setw(10) << stats.live() << std::setw(10) << stats.peak
+              << std::setw(8) << stats.slabs << std::endl;
+  };
+  for (size_t i = 0; i < ObjectPool::kClassCount; i++) {
+    print_row(std::to_string(ObjectPool::ChunkSize(i)) + "B",
+              pool.class_stats(i));
+  }
+  print_row(">" + std::to_string(ObjectPool::kPoolLimit) + "B",
+            pool.large_stats());
+  std::cerr << "[mem] pool allocations: " << allocations
+            << ", system allocations: " << system_allocations << std::endl;
+
+  const Heap::Stats& heap = Heap::Instance().stats();
+  std::cerr << "[gc] collections: " << heap.collections
+            << ", freed: " << heap.freed << ", peak objects: " << heap.peak
+            << std::endl;
 }
 
 void Lox::Error(int line, const std::string& message) {
@@ -66,7 +143,7 @@ void Lox::Error(Token token, const std::string& message) {
   if (token.type() == TokenType::EEOF) {
     Report(token.line(), " at end", message);
   } else {
-    Report(token.line(), " at '" + token.lexeme() + "'", message);
+    Report(token.line(), " at '" + std::string(token.lexeme()) + "'", message);
   }
 }
 
@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include "lox_interpreter/ast/visitors/interpreter.h"
+#include "lox_interpreter/core/source.h"
 #include "lox_interpreter/core/token.h"
 #include "lox_interpreter/util/runtime_error.h"
 
@@ -18,6 +20,18 @@ class Lox {
   void RunFile(const std::string& path);
   void RunPrompt();
 
+  // 运行结束后把属性访问内联缓存的命中统计打印到 stderr
+  void set_print_cache_stats(bool enabled) { print_cache_stats_ = enabled; }
+
+  // 运行结束后把内存池各级别的分配统计和环回收统计打印到 stderr
+  void set_print_memory_stats(bool enabled) { print_memory_stats_ = enabled; }
+
+  // 选择执行后端，默认直接遍历 AST
+  void set_backend(Backend backend) { backend_ = backend; }
+
+  // 执行前先运行 AST 优化（常量折叠、删除死分支），见 Optimizer
+  void set_optimize(bool enabled) { optimize_ = enabled; }
+
   void Error(int line, const std::string& message);
   void Error(Token token, const std::string& message);
   void RuntimeError(const RuntimeError& error);
@@ -33,13 +47,20 @@ class Lox {
  private:
   Lox() = default;
 
-  void run(const std::string& source);
+  void run(Source source);
 
   void Report(int line, const std::string& where, const std::string& message);
 
+  void PrintCacheStats() const;
+  void PrintMemoryStats() const;
+
  private:
   bool has_error_ = false;
   bool has_runtime_error_ = false;
+  bool print_cache_stats_ = false;
+  bool print_memory_stats_ = false;
+  Backend backend_ = Backend::AST;
+  bool optimize_ = false;
 };
 
 }  // namespace lox
@@ -0,0 +1,57 @@
+#ifndef LOX_CORE_OUTPUT_H_
+#define LOX_CORE_OUTPUT_H_
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "lox_interpreter/util/lox_object.h"
+
+namespace lox {
+
+// print 语句的输出缓冲。
+//
+// 每条 print 只把值的文本追加到缓冲区，攒满 kCapacity 字节才一次性写给
+// std::cout，不再像 std::endl 那样每行刷新一次。缓冲区在 Flush 时、
+// 析构时写出；解释器在每次 Interpret 结束和报告运行时错误之前调用
+// Flush，保证脚本输出与错误信息的先后顺序不变。
+//
+// 写出时才取 std::cout，测试替换它的 rdbuf 捕获输出仍然有效。
+class OutputBuffer {
+ public:
+  static constexpr size_t kCapacity = 64 * 1024;
+
+  OutputBuffer() { buffer_.reserve(kCapacity); }
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+  ~OutputBuffer() { Flush(); }
+
+  // 输出 value 和换行
+  void Print(const LoxObject& value) {
+    value.AppendTo(buffer_);
+    buffer_.push_back('\n');
+    if (buffer_.size() >= kCapacity) {
+      Drain();
+    }
+  }
+
+  // 写出缓冲的内容并刷新 std::cout
+  void Flush() {
+    Drain();
+    std::cout.flush();
+  }
+
+ private:
+  void Drain() {
+    if (!buffer_.empty()) {
+      std::cout.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+  std::string buffer_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_OUTPUT_H_
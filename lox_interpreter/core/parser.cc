@@ -35,16 +35,12 @@ bool Parser::Check(TokenType type) {
 }
 
 Token Parser::Advance() {
-  if (!IsAtEnd()) ++current_;
+  if (!IsAtEnd()) tokens_.Advance();
   return Previous();
 }
 
 bool Parser::IsAtEnd() { return Peek().type() == TokenType::EEOF; }
 
-Token Parser::Previous() { return tokens_[current_ - 1]; }
-
-Token Parser::Peek() { return tokens_[current_]; }
-
 Token Parser::Consume(TokenType type, const std::string& message) {
   if (Check(type)) return Advance();
   throw Error(Peek(), message);
@@ -86,8 +82,10 @@ ExprPtr Parser::FinishCall(ExprPtr callee) {
     } while (Match({TokenType::COMMA}));
   }
   Token paren = Consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
-  return std::make_unique<CallExpr>(std::move(callee), paren,
-                                    std::move(arguments));
+  auto call = arena_.New<CallExpr>(std::move(callee), paren,
+                                   std::move(arguments));
+  call->method_ = dynamic_cast<GetExpr*>(call->callee_.get());
+  return call;
 }
 
 // ==================== Grammar Parsing Expr Functions ====================
@@ -99,7 +97,7 @@ ExprPtr Parser::ParseEquality() {
   while (Match({TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL})) {
     Token op = Previous();
     ExprPtr right = ParseComparison();
-    expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<BinaryExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -110,7 +108,7 @@ ExprPtr Parser::ParseComparison() {
                 TokenType::LESS_EQUAL})) {
     Token op = Previous();
     ExprPtr right = ParseTerm();
-    expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<BinaryExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -120,7 +118,7 @@ ExprPtr Parser::ParseTerm() {
   while (Match({TokenType::MINUS, TokenType::PLUS})) {
     Token op = Previous();
     ExprPtr right = ParseFactor();
-    expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<BinaryExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -130,7 +128,7 @@ ExprPtr Parser::ParseFactor() {
   while (Match({TokenType::SLASH, TokenType::STAR})) {
     Token op = Previous();
     ExprPtr right = ParseUnary();
-    expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<BinaryExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -141,7 +139,7 @@ ExprPtr Parser::ParseBinary(std::function<ExprPtr()> next,
   while (Match(types)) {
     Token op = Previous();
     ExprPtr right = next();
-    expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<BinaryExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -150,7 +148,7 @@ ExprPtr Parser::ParseUnary() {
   if (Match({TokenType::BANG, TokenType::MINUS})) {
     Token op = Previous();
     ExprPtr right = ParseUnary();
-    return std::make_unique<UnaryExpr>(op, std::move(right));
+    return arena_.New<UnaryExpr>(op, std::move(right));
   }
   return ParseCall();
 }
@@ -163,7 +161,7 @@ ExprPtr Parser::ParseCall() {
     } else if (Match({TokenType::DOT})) {
       Token name =
           Consume(TokenType::IDENTIFIER, "Expect property name after '.'.");
-      expr = std::make_unique<GetExpr>(std::move(expr), name);
+      expr = arena_.New<GetExpr>(std::move(expr), name);
     } else {
       break;
     }
@@ -173,39 +171,39 @@ ExprPtr Parser::ParseCall() {
 
 ExprPtr Parser::ParsePrimary() {
   if (Match({TokenType::TRUE}))
-    return std::make_unique<LiteralExpr>(LoxObject(true));
+    return arena_.New<LiteralExpr>(LoxObject(true));
 
   if (Match({TokenType::FALSE}))
-    return std::make_unique<LiteralExpr>(LoxObject(false));
+    return arena_.New<LiteralExpr>(LoxObject(false));
 
   if (Match({TokenType::NIL}))
-    return std::make_unique<LiteralExpr>(LoxObject(nullptr));
+    return arena_.New<LiteralExpr>(LoxObject(nullptr));
 
   if (Match({TokenType::NUMBER, TokenType::STRING}))
-    return std::make_unique<LiteralExpr>(Previous().literal());
+    return arena_.New<LiteralExpr>(Previous().literal());
 
   if (Match({TokenType::SUPER})) {
     Token keyword = Previous();
     Consume(TokenType::DOT, "Expect '.' after 'super'.");
     Token method =
         Consume(TokenType::IDENTIFIER, "Expect superclass method name.");
-    return std::make_unique<SuperExpr>(keyword, method);
+    return arena_.New<SuperExpr>(keyword, method);
   }
 
   if (Match({TokenType::THIS})) {
     Token keyword = Previous();
-    return std::make_unique<ThisExpr>(keyword);
+    return arena_.New<ThisExpr>(keyword);
   }
 
   if (Match({TokenType::IDENTIFIER})) {
     Token name = Previous();
-    return std::make_unique<VariableExpr>(name);
+    return arena_.New<VariableExpr>(name);
   }
 
   if (Match({TokenType::LEFT_PAREN})) {
     ExprPtr expr = Expression();
     Consume(TokenType::RIGHT_PAREN, "Expect ')' after expression.");
-    return std::make_unique<GroupingExpr>(std::move(expr));
+    return arena_.New<GroupingExpr>(std::move(expr));
   }
 
   throw Error(Peek(), "Expect expression.");
@@ -220,12 +218,12 @@ ExprPtr Parser::ParseAssignment() {
 
     VariableExpr* variable = dynamic_cast<VariableExpr*>(expr.get());
     if (variable != nullptr) {
-      return std::make_unique<AssignExpr>(variable->name_, std::move(value));
+      return arena_.New<AssignExpr>(variable->name_, std::move(value));
     }
     GetExpr* get = dynamic_cast<GetExpr*>(expr.get());
     if (get != nullptr) {
-      return std::make_unique<SetExpr>(std::move(get->object_), get->name_,
-                                       std::move(value));
+      return arena_.New<SetExpr>(std::move(get->object_), get->name_,
+                                 std::move(value));
     }
 
     throw Error(equals_token, "Invalid assignment target.");
@@ -239,7 +237,7 @@ ExprPtr Parser::ParseOr() {
   while (Match({TokenType::OR})) {
     Token op = Previous();
     ExprPtr right = ParseAnd();
-    expr = std::make_unique<LogicalExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<LogicalExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -249,7 +247,7 @@ ExprPtr Parser::ParseAnd() {
   while (Match({TokenType::AND})) {
     Token op = Previous();
     ExprPtr right = ParseEquality();
-    expr = std::make_unique<LogicalExpr>(std::move(expr), op, std::move(right));
+    expr = arena_.New<LogicalExpr>(std::move(expr), op, std::move(right));
   }
   return expr;
 }
@@ -273,14 +271,14 @@ StmtPtr Parser::Statement() {
   if (Match({TokenType::PRINT})) return PrintStatement();
   if (Match({TokenType::RETURN})) return ReturnStatement();
   if (Match({TokenType::LEFT_BRACE}))
-    return std::make_unique<BlockStmt>(Block());
+    return arena_.New<BlockStmt>(Block());
   return ExprStatement();
 }
 
 StmtPtr Parser::PrintStatement() {
   ExprPtr value = Expression();
   Consume(TokenType::SEMICOLON, "Expect ';' after value.");
-  return std::make_unique<PrintStmt>(std::move(value));
+  return arena_.New<PrintStmt>(std::move(value));
 }
 
 StmtPtr Parser::ReturnStatement() {
@@ -290,18 +288,19 @@ StmtPtr Parser::ReturnStatement() {
     value = Expression();
   }
   Consume(TokenType::SEMICOLON, "Expect ';' after return value.");
-  return std::make_unique<ReturnStmt>(keyword, std::move(value));
+  return arena_.New<ReturnStmt>(keyword, std::move(value));
 }
 
 StmtPtr Parser::ExprStatement() {
   ExprPtr expr = Expression();
   Consume(TokenType::SEMICOLON, "Expect ';' after expression.");
-  return std::make_unique<ExprStmt>(std::move(expr));
+  return arena_.New<ExprStmt>(std::move(expr));
 }
 
 StmtPtr Parser::BreakStatement() {
+  Token keyword = Previous();
   Consume(TokenType::SEMICOLON, "Expect ';' after 'break'.");
-  return std::make_unique<BreakStmt>();
+  return arena_.New<BreakStmt>(keyword);
 }
 
 StmtPtr Parser::Declaration() {
@@ -323,7 +322,7 @@ StmtPtr Parser::VarDeclaration() {
     initializer = Expression();
   }
   Consume(TokenType::SEMICOLON, "Expect ';' after variable declaration.");
-  return std::make_unique<VarStmt>(name, std::move(initializer));
+  return arena_.New<VarStmt>(name, std::move(initializer));
 }
 
 StmtPtr Parser::FuncDeclaration(std::string kind) {
@@ -342,8 +341,8 @@ StmtPtr Parser::FuncDeclaration(std::string kind) {
   Consume(TokenType::RIGHT_PAREN, "Expect ')' after parameters.");
   Consume(TokenType::LEFT_BRACE, "Expect '{' before " + kind + " body.");
   std::vector<StmtPtr> body = Block();
-  return std::make_unique<FunctionStmt>(std::move(name), std::move(parameters),
-                                        std::move(body));
+  return arena_.New<FunctionStmt>(std::move(name), std::move(parameters),
+                                  std::move(body));
 }
 
 StmtPtr Parser::MethodDeclaration(bool is_static) {
@@ -374,8 +373,8 @@ StmtPtr Parser::MethodDeclaration(bool is_static) {
     body = Block();
   }
 
-  return std::make_unique<FunctionStmt>(std::move(name), std::move(parameters),
-                                        std::move(body), is_static, is_getter);
+  return arena_.New<FunctionStmt>(std::move(name), std::move(parameters),
+                                  std::move(body), is_static, is_getter);
 }
 
 StmtPtr Parser::ClassDeclaration() {
@@ -384,7 +383,7 @@ StmtPtr Parser::ClassDeclaration() {
   ExprPtr super_class = nullptr;
   if (Match({TokenType::LESS})) {
     Consume(TokenType::IDENTIFIER, "Expect superclass name.");
-    super_class = std::make_unique<VariableExpr>(Previous());
+    super_class = arena_.New<VariableExpr>(Previous());
   }
 
   Consume(TokenType::LEFT_BRACE, "Expect '{' before class body.");
@@ -402,8 +401,8 @@ StmtPtr Parser::ClassDeclaration() {
     }
   }
   Consume(TokenType::RIGHT_BRACE, "Expect '}' after class body.");
-  return std::make_unique<ClassStmt>(std::move(name), std::move(super_class),
-                                     std::move(methods));
+  return arena_.New<ClassStmt>(std::move(name), std::move(super_class),
+                               std::move(methods));
 }
 
 StmtPtr Parser::IfStatement() {
@@ -413,8 +412,8 @@ StmtPtr Parser::IfStatement() {
   StmtPtr then_branch = Statement();
   StmtPtr else_branch = nullptr;
   if (Match({TokenType::ELSE})) else_branch = Statement();
-  return std::make_unique<IfStmt>(std::move(condition), std::move(then_branch),
-                                  std::move(else_branch));
+  return arena_.New<IfStmt>(std::move(condition), std::move(then_branch),
+                            std::move(else_branch));
 }
 
 StmtPtr Parser::WhileStatement() {
@@ -422,7 +421,7 @@ StmtPtr Parser::WhileStatement() {
   ExprPtr condition = Expression();
   Consume(TokenType::RIGHT_PAREN, "Expect ')' after condition.");
   StmtPtr body = Statement();
-  return std::make_unique<WhileStmt>(std::move(condition), std::move(body));
+  return arena_.New<WhileStmt>(std::move(condition), std::move(body));
 }
 
 StmtPtr Parser::ForStatement() {
@@ -452,18 +451,18 @@ StmtPtr Parser::ForStatement() {
   if (increment != nullptr) {
     std::vector<StmtPtr> block;
     block.push_back(std::move(body));
-    block.push_back(std::make_unique<ExprStmt>(std::move(increment)));
-    body = std::make_unique<BlockStmt>(std::move(block));
+    block.push_back(arena_.New<ExprStmt>(std::move(increment)));
+    body = arena_.New<BlockStmt>(std::move(block));
   }
   if (condition == nullptr) {
-    condition = std::make_unique<LiteralExpr>(LoxObject(true));
+    condition = arena_.New<LiteralExpr>(LoxObject(true));
   }
-  body = std::make_unique<WhileStmt>(std::move(condition), std::move(body));
+  body = arena_.New<WhileStmt>(std::move(condition), std::move(body));
   if (initializer != nullptr) {
     std::vector<StmtPtr> block;
     block.push_back(std::move(initializer));
     block.push_back(std::move(body));
-    body = std::make_unique<BlockStmt>(std::move(block));
+    body = arena_.New<BlockStmt>(std::move(block));
   }
   return body;
 }
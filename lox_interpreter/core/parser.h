@@ -6,7 +6,10 @@
 #include <functional>
 #include <stdexcept>
 
+#include "lox_interpreter/core/scanner.h"
 #include "lox_interpreter/core/token.h"
+#include "lox_interpreter/core/token_stream.h"
+#include "lox_interpreter/ast/arena.h"
 #include "lox_interpreter/ast/expr.h"
 #include "lox_interpreter/ast/stmt.h"
 #include "lox_interpreter/util/token_type.h"
@@ -22,7 +25,10 @@ class Parser {
         : std::runtime_error(message) {}
   };
 
-  Parser(const std::vector<Token>& tokens) : tokens_(std::move(tokens)) {}
+  // 边解析边从 scanner 拉取 token。解析出的节点都分配在 arena 中，
+  // 调用方需保证 arena 比语法树活得久
+  Parser(Scanner& scanner, AstArena& arena)
+      : tokens_(scanner), arena_(arena) {}
 
   std::vector<StmtPtr> Parse();
 
@@ -32,8 +38,8 @@ class Parser {
   bool Check(TokenType type);
   Token Advance();
   bool IsAtEnd();
-  Token Previous();
-  Token Peek();
+  const Token& Previous() const { return tokens_.Previous(); }
+  const Token& Peek() const { return tokens_.Peek(); }
   Token Consume(TokenType type, const std::string& message);
   ParseError Error(Token token, const std::string& message);
   void Synchronize();
@@ -75,8 +81,8 @@ class Parser {
   StmtPtr ReturnStatement();
 
  private:
-  std::vector<Token> tokens_;
-  int current_ = 0;
+  TokenStream tokens_;
+  AstArena& arena_;
 };
 
 }  // namespace lox
@@ -0,0 +1,93 @@
+#include "lox_interpreter/core/pool.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace lox {
+
+namespace {
+
+// 退役时还有块没归还的池
+std::vector<ObjectPool*>& RetiredPools() {
+  static std::vector<ObjectPool*>* pools = new std::vector<ObjectPool*>();
+  return *pools;
+}
+
+}  // namespace
+
+ObjectPool::Handle ObjectPool::Create() {
+  ReleaseRetired();
+  return Handle(new ObjectPool());
+}
+
+void ObjectPool::Retire::operator()(ObjectPool* pool) const {
+  RetiredPools().push_back(pool);
+  ReleaseRetired();
+}
+
+void ObjectPool::ReleaseRetired() {
+  std::vector<ObjectPool*>& pools = RetiredPools();
+  auto empty = std::partition(
+      pools.begin(), pools.end(),
+      [](const ObjectPool* pool) { return pool->live() > 0; });
+  for (auto it = empty; it != pools.end(); ++it) {
+    delete *it;
+  }
+  pools.erase(empty, pools.end());
+}
+
+ObjectPool::~ObjectPool() {
+  while (slabs_ != nullptr) {
+    Slab* next = slabs_->next;
+    ::operator delete(slabs_, std::align_val_t(kSlabSize));
+    slabs_ = next;
+  }
+}
+
+uint64_t ObjectPool::live() const {
+  uint64_t live = large_stats_.live();
+  for (const SizeClass& size_class : classes_) {
+    live += size_class.stats.live();
+  }
+  return live;
+}
+
+void ObjectPool::Refill(SizeClass& size_class, size_t index) {
+  size_t chunk_size = ChunkSize(index);
+  // 按 kSlabSize 对齐，Free 把块地址的低位清零就能找到 slab 头部
+  auto* slab = static_cast<Slab*>(
+      ::operator new(kSlabSize, std::align_val_t(kSlabSize)));
+  slab->pool = this;
+  slab->next = slabs_;
+  slabs_ = slab;
+  size_class.stats.slabs++;
+  // 倒序挂入链表，分配时按地址递增取出
+  char* chunks = reinterpret_cast<char*>(slab) + kGranularity;
+  size_t capacity = kSlabSize - kGranularity;
+  for (size_t offset = capacity / chunk_size * chunk_size; offset > 0;) {
+    offset -= chunk_size;
+    auto* chunk = reinterpret_cast<FreeChunk*>(chunks + offset);
+    chunk->next = size_class.free;
+    size_class.free = chunk;
+  }
+}
+
+void* ObjectPool::AllocateLarge(size_t size) {
+  large_stats_.allocations++;
+  large_stats_.slabs++;
+  if (large_stats_.live() > large_stats_.peak) {
+    large_stats_.peak = large_stats_.live();
+  }
+  auto* header =
+      static_cast<LargeHeader*>(::operator new(sizeof(LargeHeader) + size));
+  header->pool = this;
+  return header + 1;
+}
+
+void ObjectPool::FreeLarge(void* memory, size_t size) {
+  LargeHeader* header = static_cast<LargeHeader*>(memory) - 1;
+  header->pool->large_stats_.frees++;
+  ::operator delete(header, sizeof(LargeHeader) + size);
+}
+
+}  // namespace lox
@@ -0,0 +1,216 @@
+#ifndef LOX_CORE_POOL_H_
+#define LOX_CORE_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace lox {
+
+// 运行时小对象（实例、函数、Cell、字符串、字段数组……）的分级内存池。
+//
+// 请求大小按 16 字节向上取整分成若干级，每级维护一条空闲链表：释放的
+// 块挂回所属级别的链表头，下次同样大小的分配直接取走，刚释放的内存
+// 还在缓存里；链表空了才整块（kSlabSize）向系统申请，再切成等大的块。
+// 超过 kMaxSize 的请求直接交给 ::operator new。
+//
+// 每个 Interpreter 持有自己的池，执行期间通过 Scope 设为当前池，
+// RefCounted 和 PoolAllocator 从当前池分配；没有解释器在执行时（测试、
+// 基准里直接创建的对象）落在进程级的默认池。释放时不看当前池：slab 按自身
+// 大小对齐，开头记着所属的池，超大请求前面也留了记录所属池的头部，
+// 块总是回到分配它的池，几个解释器之间不会混用空闲链表。
+//
+// 内存只在本级内复用，池销毁时才归还系统。解释器是单线程的，不加锁。
+class ObjectPool {
+ public:
+  static constexpr size_t kGranularity = 16;
+  static constexpr size_t kMaxSize = 512;
+  static constexpr size_t kClassCount = kMaxSize / kGranularity;
+  static constexpr size_t kSlabSize = 16 * 1024;
+
+#ifdef __SANITIZE_ADDRESS__
+  // ASan 构建中所有请求都直接向系统申请，否则复用的块会掩盖释放后使用
+  static constexpr size_t kPoolLimit = 0;
+#else
+  static constexpr size_t kPoolLimit = kMaxSize;
+#endif
+
+  struct Stats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    // 向系统申请的次数：分级的是 slab 数，超大请求是每次分配
+    uint64_t slabs = 0;
+    // 同时在用的块数的峰值
+    uint64_t peak = 0;
+
+    uint64_t live() const { return allocations - frees; }
+  };
+
+  // 池析构时如果还有块没归还（没回收的垃圾环、比解释器活得久的对象），
+  // 这些块之后仍会释放回池，只能先把池留下，等下次创建或退役池时
+  // 发现块已全部归还再删除
+  struct Retire {
+    void operator()(ObjectPool* pool) const;
+  };
+  using Handle = std::unique_ptr<ObjectPool, Retire>;
+
+  static Handle Create();
+
+  // 没有解释器在执行时使用的池。有意不析构：退出时静态对象里仍可能有
+  // 对象释放回池
+  static ObjectPool& Default() {
+    static ObjectPool* pool = new ObjectPool();
+    return *pool;
+  }
+
+  static ObjectPool& Current() {
+    ObjectPool* pool = CurrentSlot();
+    return pool != nullptr ? *pool : Default();
+  }
+
+  // 在作用域内把 pool 设为当前池，退出时恢复原来的
+  class Scope {
+   public:
+    explicit Scope(ObjectPool& pool)
+        : previous_(std::exchange(CurrentSlot(), &pool)) {}
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() { CurrentSlot() = previous_; }
+
+   private:
+    ObjectPool* previous_;
+  };
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  // size 必须大于 0
+  void* Allocate(size_t size) {
+    if (size > kPoolLimit) {
+      return AllocateLarge(size);
+    }
+    SizeClass& size_class = classes_[ClassIndex(size)];
+    Stats& stats = size_class.stats;
+    if (++stats.allocations - stats.frees > stats.peak) {
+      stats.peak = stats.allocations - stats.frees;
+    }
+    if (size_class.free == nullptr) {
+      Refill(size_class, ClassIndex(size));
+    }
+    FreeChunk* chunk = size_class.free;
+    size_class.free = chunk->next;
+    return chunk;
+  }
+
+  // 把 memory 还给分配它的池，不一定是当前池。size 必须与分配时相同
+  static void Free(void* memory, size_t size) {
+    if (size > kPoolLimit) {
+      FreeLarge(memory, size);
+      return;
+    }
+    Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(memory) &
+                                         ~uintptr_t{kSlabSize - 1});
+    SizeClass& size_class = slab->pool->classes_[ClassIndex(size)];
+    size_class.stats.frees++;
+    auto* chunk = static_cast<FreeChunk*>(memory);
+    chunk->next = size_class.free;
+    size_class.free = chunk;
+  }
+
+  // 第 index 级的块大小
+  static size_t ChunkSize(size_t index) { return (index + 1) * kGranularity; }
+
+  const Stats& class_stats(size_t index) const {
+    return classes_[index].stats;
+  }
+  const Stats& large_stats() const { return large_stats_; }
+
+  // 还没归还的块数（包括超大请求）
+  uint64_t live() const;
+
+ private:
+  struct FreeChunk {
+    FreeChunk* next;
+  };
+
+  struct SizeClass {
+    FreeChunk* free = nullptr;
+    Stats stats;
+  };
+
+  // 每个 slab 的开头，第一个块从 kGranularity 处开始
+  struct Slab {
+    ObjectPool* pool;
+    Slab* next;
+  };
+  static_assert(sizeof(Slab) <= kGranularity, "slab 头部占不止一个粒度");
+
+  // 超大请求前面的头部，保持返回的地址按 kGranularity 对齐
+  struct alignas(kGranularity) LargeHeader {
+    ObjectPool* pool;
+  };
+
+  ObjectPool() = default;
+  ~ObjectPool();
+
+  // 当前池，为空表示默认池。指针是常量初始化的，读取时不需要检查
+  // 静态变量是否已经初始化
+  static ObjectPool*& CurrentSlot() {
+    static ObjectPool* current = nullptr;
+    return current;
+  }
+
+  // 删除已退役且块已全部归还的池
+  static void ReleaseRetired();
+
+  static size_t ClassIndex(size_t size) {
+    return (size - 1) / kGranularity;
+  }
+
+  // 申请一个 slab 切成 index 级的块挂到空闲链表
+  void Refill(SizeClass& size_class, size_t index);
+
+  void* AllocateLarge(size_t size);
+  static void FreeLarge(void* memory, size_t size);
+
+  SizeClass classes_[kClassCount];
+  Stats large_stats_;
+  // 向系统申请的所有 slab，析构时逐个归还
+  Slab* slabs_ = nullptr;
+};
+
+// 从 ObjectPool 分配的标准库分配器，用于运行时对象内部的小数组
+template <typename T>
+class PoolAllocator {
+ public:
+  static_assert(alignof(T) <= ObjectPool::kGranularity,
+                "ObjectPool 只保证 16 字节对齐");
+
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(ObjectPool::Current().Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* memory, size_t n) {
+    ObjectPool::Free(memory, n * sizeof(T));
+  }
+
+  // 内存总是释放回分配它的池，任意两个实例都可以释放对方分配的内存
+  friend bool operator==(const PoolAllocator&, const PoolAllocator&) {
+    return true;
+  }
+  friend bool operator!=(const PoolAllocator&, const PoolAllocator&) {
+    return false;
+  }
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_POOL_H_
@@ -4,23 +4,28 @@
 #include "lox_interpreter/core/lox.h"
 #include "lox_interpreter/util/lox_object.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace lox {
 
 LoxObject Resolver::Visit(VariableExpr& variable_expr) {
-  if (!scopes_.empty() &&
-      scopes_.back().find(variable_expr.name_.lexeme()) !=
-          scopes_.back().end() &&
-      !scopes_.back()[variable_expr.name_.lexeme()]) {
-    Lox::Instance().Error(variable_expr.name_,
-                          "Cannot read local variable in its own initializer.");
-  }
-  ResolveLocal(variable_expr, variable_expr.name_);
+  if (!scopes_.empty()) {
+    auto& variables = scopes_.back().variables;
+    auto it = variables.find(variable_expr.name_.symbol());
+    if (it != variables.end() && !it->second.defined) {
+      Lox::Instance().Error(
+          variable_expr.name_,
+          "Cannot read local variable in its own initializer.");
+    }
+  }
+  ResolveLocal(variable_expr.name_, variable_expr.ref_);
   return nullptr;
 }
 
 LoxObject Resolver::Visit(AssignExpr& assign_expr) {
   Resolve(assign_expr.value_);
-  ResolveLocal(assign_expr, assign_expr.name_);
+  ResolveLocal(assign_expr.name_, assign_expr.ref_);
   return nullptr;
 }
 
@@ -49,7 +54,7 @@ LoxObject Resolver::Visit(ThisExpr& this_expr) {
                           "Cannot use 'this' outside of a class.");
     return nullptr;
   }
-  ResolveLocal(this_expr, this_expr.keyword_);
+  ResolveLocal(this_expr.keyword_, this_expr.ref_);
   return nullptr;
 }
 
@@ -88,43 +93,55 @@ LoxObject Resolver::Visit(SuperExpr& super_expr) {
     Lox::Instance().Error(super_expr.keyword_,
                           "Can't use 'super' in a class with no superclass.");
   }
-  ResolveLocal(super_expr, super_expr.keyword_);
+  ResolveLocal(super_expr.keyword_, super_expr.ref_);
+  ResolveLocal(Symbol::Intern("this"), super_expr.keyword_,
+               super_expr.this_ref_);
   return nullptr;
 }
 
-void Resolver::Visit(BlockStmt& block_stmt) {
+Completion Resolver::Visit(BlockStmt& block_stmt) {
   BeginScope();
-  Resolve(block_stmt.statements_);
+  ResolveStatements(block_stmt.statements_);
   EndScope();
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(VarStmt& var_stmt) {
-  Declare(var_stmt.name_);
+Completion Resolver::Visit(VarStmt& var_stmt) {
+  Declare(var_stmt.name_, &var_stmt.ref_);
   if (var_stmt.initializer_ != nullptr) {
     Resolve(var_stmt.initializer_);
   }
   Define(var_stmt.name_);
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(FunctionStmt& function_stmt) {
-  Declare(function_stmt.name_);
+Completion Resolver::Visit(FunctionStmt& function_stmt) {
+  Declare(function_stmt.name_, &function_stmt.ref_);
   Define(function_stmt.name_);
   ResolveFunction(function_stmt, FunctionType::FUNCTION);
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(ExprStmt& expr_stmt) { Resolve(expr_stmt.expr_); }
+Completion Resolver::Visit(ExprStmt& expr_stmt) {
+  Resolve(expr_stmt.expr_);
+  return Completion::NORMAL;
+}
 
-void Resolver::Visit(IfStmt& if_stmt) {
+Completion Resolver::Visit(IfStmt& if_stmt) {
   Resolve(if_stmt.condition_);
   Resolve(if_stmt.then_branch_);
   if (if_stmt.else_branch_ != nullptr) {
     Resolve(if_stmt.else_branch_);
   }
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(PrintStmt& print_stmt) { Resolve(print_stmt.expr_); }
+Completion Resolver::Visit(PrintStmt& print_stmt) {
+  Resolve(print_stmt.expr_);
+  return Completion::NORMAL;
+}
 
-void Resolver::Visit(ReturnStmt& return_stmt) {
+Completion Resolver::Visit(ReturnStmt& return_stmt) {
   if (current_function_ == FunctionType::NONE) {
     Lox::Instance().Error(return_stmt.keyword_,
                           "Cannot return from top-level code.");
@@ -136,28 +153,36 @@ void Resolver::Visit(ReturnStmt& return_stmt) {
     }
     Resolve(return_stmt.value_);
   }
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(WhileStmt& while_stmt) {
+Completion Resolver::Visit(WhileStmt& while_stmt) {
   Resolve(while_stmt.condition_);
+  ++loop_depth_;
   Resolve(while_stmt.body_);
+  --loop_depth_;
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(BreakStmt& break_stmt) {
-  (void)break_stmt;  // Break 语句不需要解析
+Completion Resolver::Visit(BreakStmt& break_stmt) {
+  if (loop_depth_ == 0) {
+    Lox::Instance().Error(break_stmt.keyword_,
+                          "Can't use 'break' outside of a loop.");
+  }
+  return Completion::NORMAL;
 }
 
-void Resolver::Visit(ClassStmt& class_stmt) {
+Completion Resolver::Visit(ClassStmt& class_stmt) {
   ClassType enclosing_class = current_class_;
   current_class_ = ClassType::CLASS;
 
-  Declare(class_stmt.name_);
+  Declare(class_stmt.name_, &class_stmt.ref_);
   Define(class_stmt.name_);
 
   if (class_stmt.superclass_ != nullptr) {
     current_class_ = ClassType::SUBCLASS;
     auto& superclass_var = static_cast<VariableExpr&>(*class_stmt.superclass_);
-    if (class_stmt.name_.lexeme() == superclass_var.name_.lexeme()) {
+    if (class_stmt.name_.symbol() == superclass_var.name_.symbol()) {
       Lox::Instance().Error(superclass_var.name_,
                             "A class can't inherit from itself.");
     }
@@ -166,30 +191,33 @@ void Resolver::Visit(ClassStmt& class_stmt) {
 
   if (class_stmt.superclass_ != nullptr) {
     BeginScope();
-    scopes_.back()["super"] = true;
+    DeclareImplicit(Symbol::Intern("super"), &class_stmt.super_ref_);
   }
 
-  BeginScope();
-  scopes_.back()["this"] = true;
-
+  static const Symbol kInit = Symbol::Intern("init");
   for (auto& method : class_stmt.methods_) {
     FunctionType type = FunctionType::METHOD;
-    if (method.name_.lexeme() == "init") {
+    if (method.name_.symbol() == kInit) {
       type = FunctionType::INITIALIZER;
     }
     ResolveFunction(method, type);
   }
 
-  EndScope();
-
   if (class_stmt.superclass_ != nullptr) {
     EndScope();
   }
 
   current_class_ = enclosing_class;
+  return Completion::NORMAL;
 }
 
+// 顶层代码自身也占一个栈帧，槽位数交给解释器预留
 void Resolver::Resolve(const std::vector<StmtPtr>& statements) {
+  ResolveStatements(statements);
+  interpreter_.ReserveTopLevelSlots(functions_.front().frame_size);
+}
+
+void Resolver::ResolveStatements(const std::vector<StmtPtr>& statements) {
   for (auto& statement : statements) {
     Resolve(statement);
   }
@@ -199,46 +227,148 @@ void Resolver::Resolve(const StmtPtr& statement) { statement->Accept(*this); }
 
 void Resolver::Resolve(const ExprPtr& expression) { expression->Accept(*this); }
 
-void Resolver::ResolveLocal(const Expr& expression, const Token& name) {
+void Resolver::ResolveLocal(const Token& name, VariableRef& ref) {
+  ResolveLocal(name.symbol(), name, ref);
+}
+
+// 解析结果直接写回 AST 节点：
+//   - 当前函数内的变量按栈帧槽位访问，已被捕获的经由槽位上的 Cell 访问
+//   - 外层函数的变量标记为被捕获，当前函数通过 upvalue 访问
+//   - 不在任何局部作用域中的名字按全局变量处理，slot 为全局变量表下标
+void Resolver::ResolveLocal(Symbol name, const Token& token,
+                            VariableRef& ref) {
+  int current = static_cast<int>(functions_.size()) - 1;
   for (int i = scopes_.size() - 1; i >= 0; --i) {
-    if (scopes_.at(i).find(name.lexeme()) != scopes_.at(i).end()) {
-      interpreter_.Resolve(expression, scopes_.size() - i - 1);
-      return;
+    auto it = scopes_[i].variables.find(name);
+    if (it == scopes_[i].variables.end()) continue;
+    Variable& variable = it->second;
+    if (scopes_[i].function == current) {
+      ref.kind = variable.captured ? VariableRef::Kind::CELL
+                                   : VariableRef::Kind::LOCAL;
+      ref.slot = variable.slot;
+      variable.refs.push_back(&ref);
+    } else {
+      Capture(variable);
+      ref.kind = VariableRef::Kind::UPVALUE;
+      ref.slot = ResolveUpvalue(current, scopes_[i].function, variable.slot);
+    }
+    return;
+  }
+  ref.kind = VariableRef::Kind::GLOBAL;
+  ref.slot = interpreter_.GlobalSlot(token);
+}
+
+// 与 clox 相同：直接外层函数的变量从其栈帧槽位捕获，更外层的变量经由
+// 每一层中间函数的 upvalue 逐层传递。返回 function 中的 upvalue 下标
+int Resolver::ResolveUpvalue(int function, int declaring_function, int slot) {
+  FunctionStmt::Upvalue upvalue;
+  upvalue.is_local = function - 1 == declaring_function;
+  upvalue.index = upvalue.is_local
+                      ? slot
+                      : ResolveUpvalue(function - 1, declaring_function, slot);
+
+  auto& upvalues = functions_[function].stmt->upvalues_;
+  for (size_t i = 0; i < upvalues.size(); i++) {
+    if (upvalues[i].is_local == upvalue.is_local &&
+        upvalues[i].index == upvalue.index) {
+      return static_cast<int>(i);
     }
   }
+  upvalues.push_back(upvalue);
+  return static_cast<int>(upvalues.size()) - 1;
 }
 
-void Resolver::ResolveFunction(const FunctionStmt& function_stmt,
+void Resolver::ResolveFunction(FunctionStmt& function_stmt,
                                FunctionType type) {
   FunctionType enclosing_function = current_function_;
+  int enclosing_loop_depth = loop_depth_;
   current_function_ = type;
+  loop_depth_ = 0;  // break 不能跨越函数边界
+  function_stmt.upvalues_.clear();
+  function_stmt.captured_parameters_.clear();
+  functions_.push_back(Function{&function_stmt});
   BeginScope();
+  // 参数依次占栈帧开头的槽位，方法的 this 紧随其后
   for (auto& param : function_stmt.parameters_) {
-    Declare(param);
+    Declare(param, nullptr)->parameter = true;
     Define(param);
   }
-  Resolve(function_stmt.body_);
+  if (type == FunctionType::METHOD || type == FunctionType::INITIALIZER) {
+    DeclareImplicit(Symbol::Intern("this"), nullptr).parameter = true;
+  }
+  ResolveStatements(function_stmt.body_);
+  for (auto& [name, variable] : scopes_.back().variables) {
+    if (variable.parameter && variable.captured) {
+      function_stmt.captured_parameters_.push_back(variable.slot);
+    }
+  }
   EndScope();
+  function_stmt.frame_size_ = functions_.back().frame_size;
+  functions_.pop_back();
   current_function_ = enclosing_function;
+  loop_depth_ = enclosing_loop_depth;
 }
 
 void Resolver::BeginScope() {
-  scopes_.emplace_back(std::unordered_map<std::string, bool>());
+  Scope scope;
+  scope.function = static_cast<int>(functions_.size()) - 1;
+  scope.first_slot = functions_.back().next_slot;
+  scopes_.push_back(std::move(scope));
 }
 
-void Resolver::EndScope() { scopes_.pop_back(); }
+void Resolver::EndScope() {
+  functions_.back().next_slot = scopes_.back().first_slot;
+  scopes_.pop_back();
+}
 
-void Resolver::Declare(const Token& name) {
-  if (scopes_.empty()) return;
-  if (scopes_.back().find(name.lexeme()) != scopes_.back().end()) {
+// 在当前作用域声明 name，ref 非空时把声明得到的位置写进去。
+// 返回局部变量的记录，全局声明返回 nullptr
+Resolver::Variable* Resolver::Declare(const Token& name, VariableRef* ref) {
+  if (scopes_.empty()) {
+    if (ref != nullptr) {
+      ref->kind = VariableRef::Kind::GLOBAL;
+      ref->slot = interpreter_.GlobalSlot(name);
+    }
+    return nullptr;
+  }
+  auto& variables = scopes_.back().variables;
+  auto it = variables.find(name.symbol());
+  if (it != variables.end()) {
     Lox::Instance().Error(
         name, "Variable with this name already declared in this scope.");
+    return &it->second;
   }
-  scopes_.back()[name.lexeme()] = false;
+  Variable& variable = DeclareImplicit(name.symbol(), ref);
+  variable.defined = false;
+  return &variable;
 }
 
 void Resolver::Define(const Token& name) {
   if (scopes_.empty()) return;
-  scopes_.back()[name.lexeme()] = true;
+  scopes_.back().variables[name.symbol()].defined = true;
+}
+
+// 在当前栈帧分配一个槽位。this / super 由解释器隐式绑定，声明即定义
+Resolver::Variable& Resolver::DeclareImplicit(Symbol name, VariableRef* ref) {
+  Function& function = functions_.back();
+  Variable& variable = scopes_.back().variables[name];
+  variable.defined = true;
+  variable.slot = function.next_slot++;
+  function.frame_size = std::max(function.frame_size, function.next_slot);
+  if (ref != nullptr) {
+    ref->kind = VariableRef::Kind::LOCAL;
+    ref->slot = variable.slot;
+    variable.refs.push_back(ref);
+  }
+  return variable;
+}
+
+// 被内层函数捕获的变量改放在 Cell 里，已经解析过的引用一并改为 CELL
+void Resolver::Capture(Variable& variable) {
+  if (variable.captured) return;
+  variable.captured = true;
+  for (VariableRef* ref : variable.refs) {
+    ref->kind = VariableRef::Kind::CELL;
+  }
 }
-}  // namespace lox
\ No newline at end of file
+}  // namespace lox
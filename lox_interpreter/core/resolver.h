@@ -4,6 +4,7 @@
 #include "lox_interpreter/ast/expr.h"
 #include "lox_interpreter/ast/stmt.h"
 #include "lox_interpreter/ast/visitors/interpreter.h"
+#include "lox_interpreter/core/symbol.h"
 #include "lox_interpreter/util/lox_object.h"
 
 #include <vector>
@@ -17,16 +18,16 @@ class Resolver : public StmtVisitor, public ExprVisitor {
 
   void Resolve(const std::vector<StmtPtr>& statements);
 
-  void Visit(BlockStmt& block_stmt) override;
-  void Visit(ExprStmt& expr_stmt) override;
-  void Visit(PrintStmt& print_stmt) override;
-  void Visit(VarStmt& var_stmt) override;
-  void Visit(IfStmt& if_stmt) override;
-  void Visit(WhileStmt& while_stmt) override;
-  void Visit(BreakStmt& break_stmt) override;
-  void Visit(FunctionStmt& function_stmt) override;
-  void Visit(ReturnStmt& return_stmt) override;
-  void Visit(ClassStmt& class_stmt) override;
+  Completion Visit(BlockStmt& block_stmt) override;
+  Completion Visit(ExprStmt& expr_stmt) override;
+  Completion Visit(PrintStmt& print_stmt) override;
+  Completion Visit(VarStmt& var_stmt) override;
+  Completion Visit(IfStmt& if_stmt) override;
+  Completion Visit(WhileStmt& while_stmt) override;
+  Completion Visit(BreakStmt& break_stmt) override;
+  Completion Visit(FunctionStmt& function_stmt) override;
+  Completion Visit(ReturnStmt& return_stmt) override;
+  Completion Visit(ClassStmt& class_stmt) override;
 
   LoxObject Visit(BinaryExpr& binary) override;
   LoxObject Visit(UnaryExpr& unary) override;
@@ -55,22 +56,56 @@ class Resolver : public StmtVisitor, public ExprVisitor {
     SUBCLASS,
   };
 
+  // 局部变量在所属作用域中的信息
+  struct Variable {
+    bool defined = false;
+    int slot = 0;
+    // 是否被内层函数捕获。捕获后变量改放在 Cell 里
+    bool captured = false;
+    // 参数和 this 由调用方写进栈帧，被捕获时要在进入函数时装进 Cell
+    bool parameter = false;
+    // 在本函数内引用（含声明）这个变量的节点，被捕获时统一改为 CELL
+    std::vector<VariableRef*> refs;
+  };
+
+  struct Scope {
+    std::unordered_map<Symbol, Variable> variables;
+    // 所属函数在 functions_ 中的下标
+    int function = 0;
+    // 进入作用域时的第一个空闲槽位，离开时归还，兄弟块复用同一批槽位
+    int first_slot = 0;
+  };
+
+  // 正在解析的函数，functions_[0] 是顶层代码
+  struct Function {
+    FunctionStmt* stmt = nullptr;
+    int next_slot = 0;
+    int frame_size = 0;
+  };
+
+  void ResolveStatements(const std::vector<StmtPtr>& statements);
   void Resolve(const StmtPtr& statement);
   void Resolve(const ExprPtr& expression);
-  void ResolveLocal(const Expr& expression, const Token& name);
-  void ResolveFunction(const FunctionStmt& function_stmt, FunctionType type);
+  void ResolveLocal(const Token& name, VariableRef& ref);
+  void ResolveLocal(Symbol name, const Token& token, VariableRef& ref);
+  int ResolveUpvalue(int function, int declaring_function, int slot);
+  void ResolveFunction(FunctionStmt& function_stmt, FunctionType type);
 
   void BeginScope();
   void EndScope();
 
-  void Declare(const Token& name);
+  Variable* Declare(const Token& name, VariableRef* ref);
   void Define(const Token& name);
+  Variable& DeclareImplicit(Symbol name, VariableRef* ref);
+  void Capture(Variable& variable);
 
  private:
   Interpreter& interpreter_;
-  std::vector<std::unordered_map<std::string, bool>> scopes_;
+  std::vector<Scope> scopes_;
+  std::vector<Function> functions_{Function()};
   FunctionType current_function_ = FunctionType::NONE;
   ClassType current_class_ = ClassType::NONE;
+  int loop_depth_ = 0;  // 当前函数内嵌套的循环层数，用于检查 break
 };
 
 }  // namespace lox
@@ -1,5 +1,7 @@
 #include "lox_interpreter/core/scanner.h"
+
 #include "lox_interpreter/core/lox.h"
+#include "lox_interpreter/core/scan_simd.h"
 #include "lox_interpreter/util/token_type.h"
 
 namespace lox {
@@ -7,6 +9,13 @@ namespace lox {
 void Scanner::BlockComment() {
   int level = 1;
   while (level > 0 && !IsAtEnd()) {
+    // 注释内容整块跳过，停在下一个 '*' 或 '/'
+    size_t newlines = 0;
+    MoveTo(scan::FindCommentDelimiter(Cursor(), End(), newlines));
+    line_ += newlines;
+    if (IsAtEnd()) {
+      break;
+    }
     if (Match('/') && Match('*')) {
       ++level;
     } else if (Match('*') && Match('/')) {
@@ -24,19 +33,16 @@ void Scanner::BlockComment() {
 }
 
 void Scanner::String() {
-  while (Peek() != '"' && !IsAtEnd()) {
-    if (Peek() == '\n') {
-      ++line_;
-    }
-    Advance();
-  }
+  size_t newlines = 0;
+  MoveTo(scan::FindQuote(Cursor(), End(), newlines));
+  line_ += newlines;
   if (IsAtEnd()) {
     Lox::Instance().Error(line_, "Unterminated string.");
     return;
   }
   Advance();
-  AddToken(TokenType::STRING,
-           LoxObject(source_.substr(start_ + 1, current_ - start_ - 2)));
+  // 词素包含两侧的引号，值由 Token::literal() 取出
+  AddToken(TokenType::STRING);
 }
 
 void Scanner::Number() {
@@ -49,23 +55,22 @@ void Scanner::Number() {
       Advance();
     }
   }
-  AddToken(TokenType::NUMBER,
-           LoxObject(std::stod(source_.substr(start_, current_ - start_))));
+  AddToken(TokenType::NUMBER);
 }
 
 void Scanner::Identifier() {
-  while (IsAlpha(Peek()) || IsDigit(Peek())) {
-    Advance();
-  }
-  std::string str = source_.substr(start_, current_ - start_);
-  AddToken(stringToTokenType(str));
+  MoveTo(scan::SkipIdentifier(Cursor(), End()));
+  // 每个标识符只在这里驻留一次，之后的名字查找都按符号比较
+  Symbol symbol = Symbol::Intern(source_.substr(start_, current_ - start_));
+  TokenType type = stringToTokenType(symbol.name());
+  token_ = Token(type, symbol, static_cast<int>(line_));
+  has_token_ = true;
 }
 
-void Scanner::AddToken(TokenType type) { AddToken(type, nullptr); }
-
-void Scanner::AddToken(TokenType type, const LoxObject& literal) {
-  std::string str = source_.substr(start_, current_ - start_);
-  tokens_.push_back(Token(type, str, literal, line_));
+void Scanner::AddToken(TokenType type) {
+  token_ = Token(type, source_.substr(start_, current_ - start_),
+                 static_cast<int>(line_));
+  has_token_ = true;
 }
 
 void Scanner::ScanToken() {
@@ -115,7 +120,7 @@ void Scanner::ScanToken() {
       break;
     case '/':
       if (Match('/')) {
-        while (Peek() != '\n' && !IsAtEnd()) Advance();
+        MoveTo(scan::FindNewline(Cursor(), End()));
       } else if (Match('*')) {
         BlockComment();
       } else {
@@ -125,13 +130,18 @@ void Scanner::ScanToken() {
     case '"':
       String();
       break;
-    case ' ':
-    case '\r':
-    case '\t':
-      break;
     case '\n':
       ++line_;
+      [[fallthrough]];
+    case ' ':
+    case '\r':
+    case '\t': {
+      // 缩进和空行通常连成一片，一次跳过
+      size_t newlines = 0;
+      MoveTo(scan::SkipWhitespace(Cursor(), End(), newlines));
+      line_ += newlines;
       break;
+    }
     default:
       if (IsDigit(c)) {
         Number();
@@ -144,14 +154,35 @@ void Scanner::ScanToken() {
   }
 }
 
-std::vector<Token> Scanner::ScanTokens() {
+Token Scanner::NextToken() {
+  has_token_ = false;
   while (!IsAtEnd()) {
     start_ = current_;
     ScanToken();
+    if (has_token_) {
+      return token_;
+    }
+  }
+  return Token(TokenType::EEOF, std::string_view(), static_cast<int>(line_));
+}
+
+size_t Scanner::NextTokens(Token* out, size_t capacity) {
+  size_t count = 0;
+  while (count < capacity) {
+    out[count] = NextToken();
+    if (out[count++].type() == TokenType::EEOF) {
+      break;
+    }
   }
-  tokens_.push_back(Token(TokenType::EEOF, "", nullptr, line_));
+  return count;
+}
 
-  return tokens_;
+std::vector<Token> Scanner::ScanTokens() {
+  std::vector<Token> tokens;
+  do {
+    tokens.push_back(NextToken());
+  } while (tokens.back().type() != TokenType::EEOF);
+  return tokens;
 }
 
 }  // namespace lox
\ No newline at end of file
@@ -3,15 +3,26 @@
 
 #include "lox_interpreter/core/token.h"
 
-#include <string>
+#include <string_view>
 #include <vector>
 
 namespace lox {
 
 class Scanner {
  public:
-  Scanner(const std::string& source) : source_(source) {}
+  // 不复制源码：得到的 token 直接引用 source，调用方负责让它活得比
+  // token 久
+  Scanner(std::string_view source) : source_(source) {}
 
+  // 按需扫描下一个 token，跳过空白和注释；到达末尾后一直返回 EOF
+  Token NextToken();
+
+  // 连续扫描最多 capacity 个 token 写入 out，遇到 EOF 时写入它并停止。
+  // 返回写入的个数
+  size_t NextTokens(Token* out, size_t capacity);
+
+  // 把整份源码扫描成数组，供测试和工具使用。Parser 不经过这里，而是
+  // 通过 NextToken 边扫描边解析
   std::vector<Token> ScanTokens();
 
  private:
@@ -42,6 +53,12 @@ class Scanner {
 
   inline char Advance() { return source_[current_++]; }
 
+  // 供 scan:: 中的批量快路径使用：当前位置、源码末尾，以及把当前位置
+  // 移到快路径返回的指针处
+  const char* Cursor() const { return source_.data() + current_; }
+  const char* End() const { return source_.data() + source_.size(); }
+  void MoveTo(const char* p) { current_ = p - source_.data(); }
+
   inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
 
   inline bool IsAlpha(char c) {
@@ -60,11 +77,11 @@ class Scanner {
 
   void AddToken(TokenType type);
 
-  void AddToken(TokenType type, const LoxObject& literal);
-
  private:
-  std::string source_;
-  std::vector<Token> tokens_;
+  std::string_view source_;
+  // ScanToken 产出的 token；空白和注释不产出，has_token_ 保持 false
+  Token token_{TokenType::EEOF, std::string_view(), 1};
+  bool has_token_ = false;
 
   size_t start_ = 0;
   size_t current_ = 0;
@@ -0,0 +1,119 @@
+#include "lox_interpreter/core/source.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+namespace lox {
+
+namespace {
+
+// 关闭文件描述符的守卫，保证每条返回路径都会 close
+class FileDescriptor {
+ public:
+  explicit FileDescriptor(int fd) : fd_(fd) {}
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+  ~FileDescriptor() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int get() const { return fd_; }
+
+ private:
+  int fd_;
+};
+
+// 从 fd 读到文件末尾。expected 是预计的大小，按它一次分配到位；
+// read 可能只读到一部分，也可能被信号打断，需要循环
+bool ReadAll(int fd, size_t expected, std::string* text) {
+  constexpr size_t kChunkSize = 64 * 1024;
+  // 多留一个字节：读满 expected 之后还要再读一次才能确认到了 EOF
+  text->resize(expected + 1);
+  size_t size = 0;
+  while (true) {
+    if (size == text->size()) {
+      text->resize(size + kChunkSize);
+    }
+    ssize_t n = read(fd, text->data() + size, text->size() - size);
+    if (n == 0) {
+      break;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    size += static_cast<size_t>(n);
+  }
+  text->resize(size);
+  return true;
+}
+
+// Scanner 反正要从头读到尾：Linux 上映射时一次把所有页建好，省掉
+// 扫描过程中逐页缺页的陷入
+#ifdef MAP_POPULATE
+constexpr int kMapFlags = MAP_PRIVATE | MAP_POPULATE;
+#else
+constexpr int kMapFlags = MAP_PRIVATE;
+#endif
+
+}  // namespace
+
+Source& Source::operator=(Source&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    text_ = std::move(other.text_);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    mapping_size_ = std::exchange(other.mapping_size_, 0);
+  }
+  return *this;
+}
+
+void Source::Unmap() {
+  if (mapping_ != nullptr) {
+    munmap(const_cast<char*>(mapping_), mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+  }
+}
+
+bool Source::Load(const std::string& path, Source* source) {
+  FileDescriptor file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (file.get() < 0) {
+    return false;
+  }
+  struct stat info;
+  if (fstat(file.get(), &info) != 0) {
+    return false;
+  }
+
+  Source loaded;
+  bool regular = S_ISREG(info.st_mode);
+  size_t size = regular ? static_cast<size_t>(info.st_size) : 0;
+  if (size >= kMapThreshold) {
+    void* mapping = mmap(nullptr, size, PROT_READ, kMapFlags, file.get(), 0);
+    if (mapping != MAP_FAILED) {
+      loaded.mapping_ = static_cast<const char*>(mapping);
+      loaded.mapping_size_ = size;
+      *source = std::move(loaded);
+      return true;
+    }
+  }
+
+  // 读到 EOF 为止，管道或在 fstat 之后变长的文件也不会截断
+  if (!ReadAll(file.get(), size, &loaded.text_)) {
+    return false;
+  }
+  *source = std::move(loaded);
+  return true;
+}
+
+}  // namespace lox
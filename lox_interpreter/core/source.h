@@ -0,0 +1,54 @@
+#ifndef LOX_CORE_SOURCE_H_
+#define LOX_CORE_SOURCE_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace lox {
+
+// 一份源码文本，只能移动。
+//
+// 交互输入和小文件放在 std::string 里；大文件用 mmap 映射成只读页，
+// Scanner 直接在映射上扫描，文件内容不经过任何复制，启动开销只剩缺页。
+// 映射失败（例如文件系统不支持）或不是普通文件（管道等）时退回一次性
+// 读入。token 引用这里的文本，因此 Source 必须比语法树活得久，通常交给
+// AstArena::AdoptSource 保管。
+class Source {
+ public:
+  Source() = default;
+  explicit Source(std::string text) : text_(std::move(text)) {}
+
+  Source(Source&& other) noexcept { *this = std::move(other); }
+  Source& operator=(Source&& other) noexcept;
+  Source(const Source&) = delete;
+  Source& operator=(const Source&) = delete;
+
+  ~Source() { Unmap(); }
+
+  // 读取整个文件到 *source。文件打不开或读取出错时返回 false
+  static bool Load(const std::string& path, Source* source);
+
+  std::string_view text() const {
+    return mapping_ != nullptr ? std::string_view(mapping_, mapping_size_)
+                               : std::string_view(text_);
+  }
+
+  // 文本是否来自 mmap
+  bool mapped() const { return mapping_ != nullptr; }
+
+ private:
+  // 小于这个大小的文件直接读入：映射和解除映射的系统调用、逐页缺页的
+  // 开销比一次 read 更大
+  static constexpr size_t kMapThreshold = 64 * 1024;
+
+  void Unmap();
+
+  std::string text_;
+  const char* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_SOURCE_H_
@@ -0,0 +1,22 @@
+#include "lox_interpreter/core/symbol.h"
+
+#include <deque>
+#include <unordered_map>
+
+namespace lox {
+
+Symbol Symbol::Intern(std::string_view name) {
+  // deque 追加元素时不会移动已有元素，键里的 string_view 始终有效
+  static std::deque<std::string> storage;
+  static std::unordered_map<std::string_view, const std::string*> table;
+
+  auto it = table.find(name);
+  if (it != table.end()) {
+    return Symbol(it->second);
+  }
+  const std::string& interned = storage.emplace_back(name);
+  table.emplace(interned, &interned);
+  return Symbol(&interned);
+}
+
+}  // namespace lox
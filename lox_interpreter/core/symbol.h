@@ -0,0 +1,49 @@
+#ifndef LOX_CORE_SYMBOL_H_
+#define LOX_CORE_SYMBOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace lox {
+
+// 驻留（intern）后的标识符。整个进程内同名标识符共享同一份字符串，
+// 因此比较和哈希都只看指针，名字查找表不再需要复制或哈希字符串。
+class Symbol {
+ public:
+  Symbol() = default;
+
+  // 在全局符号表中查找或登记 name
+  static Symbol Intern(std::string_view name);
+
+  const std::string& name() const { return *name_; }
+
+  bool valid() const { return name_ != nullptr; }
+
+  bool operator==(Symbol other) const { return name_ == other.name_; }
+  bool operator!=(Symbol other) const { return name_ != other.name_; }
+
+ private:
+  friend struct std::hash<Symbol>;
+  friend class Token;
+
+  explicit Symbol(const std::string* name) : name_(name) {}
+
+  const std::string* name_ = nullptr;
+};
+
+}  // namespace lox
+
+namespace std {
+
+template <>
+struct hash<lox::Symbol> {
+  size_t operator()(lox::Symbol symbol) const noexcept {
+    return hash<const std::string*>()(symbol.name_);
+  }
+};
+
+}  // namespace std
+
+#endif  // LOX_CORE_SYMBOL_H_
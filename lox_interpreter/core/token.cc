@@ -1,11 +1,32 @@
 #include "lox_interpreter/core/token.h"
+
+#include <charconv>
+
 #include "lox_interpreter/util/token_type.h"
 #include "lox_interpreter/util/lox_object.h"
 
 namespace lox {
 
 std::string Token::ToString() const {
-  return tokenTypeToString(type_) + " " + lexeme_ + " " + literal_.ToString();
+  return tokenTypeToString(type_) + " " + std::string(lexeme()) + " " +
+         literal().ToString();
+}
+
+LoxObject Token::literal() const {
+  std::string_view text = lexeme();
+  switch (type_) {
+    case TokenType::STRING:
+      // 去掉两侧的引号
+      return LoxObject(std::string(text.substr(1, text.size() - 2)));
+    case TokenType::NUMBER: {
+      // Scanner 保证词素是 digits[.digits]，不会解析失败
+      double value = 0;
+      std::from_chars(text.data(), text.data() + text.size(), value);
+      return LoxObject(value);
+    }
+    default:
+      return nullptr;
+  }
 }
 
-}  // namespace lox
\ No newline at end of file
+}  // namespace lox
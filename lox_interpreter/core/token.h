@@ -1,36 +1,63 @@
 #ifndef LOX_CORE_TOKEN_H_
 #define LOX_CORE_TOKEN_H_
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+#include "lox_interpreter/core/symbol.h"
 #include "lox_interpreter/util/token_type.h"
 #include "lox_interpreter/util/lox_object.h"
 
 namespace lox {
 
+// 24 字节、可平凡拷贝的 token，不持有任何内存。
+//
+// 标识符和关键字的词素就是驻留后的符号名；其他 token 直接指向源码，
+// 因此源码必须比 token 活得久——语法树里的 token 要求源码和语法树
+// 一起保存（见 AstArena::AdoptSource）。字面量的值不在扫描时计算，
+// 由 literal() 从词素解析。
 class Token {
  public:
-  Token(TokenType type, const std::string& lexeme, const LoxObject& literal,
-        int line)
-      : type_(type), lexeme_(lexeme), literal_(literal), line_(line) {}
+  // lexeme 指向源码中的词素
+  Token(TokenType type, std::string_view lexeme, int line)
+      : text_(lexeme.data()),
+        length_(static_cast<uint32_t>(lexeme.size())),
+        line_(line),
+        type_(type) {}
+
+  // 标识符和关键字
+  Token(TokenType type, Symbol symbol, int line)
+      : symbol_(symbol.name_), line_(line), type_(type), has_symbol_(true) {}
 
   std::string ToString() const;
 
-  std::string lexeme() const { return lexeme_; }
+  std::string_view lexeme() const {
+    return has_symbol_ ? std::string_view(*symbol_)
+                       : std::string_view(text_, length_);
+  }
+
+  // 标识符和关键字由 Scanner 驻留后的符号，其他 token 为空
+  Symbol symbol() const { return has_symbol_ ? Symbol(symbol_) : Symbol(); }
 
   TokenType type() const { return type_; }
 
-  LoxObject literal() const { return literal_; }
+  // 字符串和数字字面量的值，其他 token 为 nil
+  LoxObject literal() const;
 
   int line() const { return line_; }
 
  private:
-  TokenType type_;
-  std::string lexeme_;
-  LoxObject literal_;
+  union {
+    const char* text_;
+    const std::string* symbol_;
+  };
+  uint32_t length_ = 0;
   int line_;
+  TokenType type_;
+  bool has_symbol_ = false;
 };
 
 }  // namespace lox
 
-#endif  // LOX_CORE_TOKEN_H_
\ No newline at end of file
+#endif  // LOX_CORE_TOKEN_H_
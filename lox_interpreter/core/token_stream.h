@@ -0,0 +1,58 @@
+#ifndef LOX_CORE_TOKEN_STREAM_H_
+#define LOX_CORE_TOKEN_STREAM_H_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "lox_interpreter/core/scanner.h"
+#include "lox_interpreter/core/token.h"
+#include "lox_interpreter/util/token_type.h"
+
+namespace lox {
+
+// Parser 的 token 来源：按需从 Scanner 拉取，扫描和解析交替进行。
+//
+// 缓冲区大小固定，不管源码多大，token 占用的内存都是常数。每次取空后
+// 一次补满一批，而不是每个 token 调一次 Scanner：两边各自在紧凑的循环
+// 里跑，分支预测和指令缓存都比逐个交替时好，一批 token 也能留在 L1 中。
+// 语法只需要回看一个 token，补充时把最后一个 token 挪到第 0 格。
+//
+// Peek/Previous 返回的引用在下一次 Advance 之后可能失效，需要保留的
+// token 要复制出来（24 字节，可平凡拷贝）。
+class TokenStream {
+ public:
+  explicit TokenStream(Scanner& scanner)
+      : scanner_(scanner),
+        buffer_(kCapacity, Token(TokenType::EEOF, std::string_view(), 0)) {
+    // 第 0 格是占位的“上一个 token”
+    size_ = 1 + scanner_.NextTokens(&buffer_[1], kCapacity - 1);
+  }
+
+  // 当前 token
+  const Token& Peek() const { return buffer_[current_]; }
+
+  // 上一个 token；还没有 Advance 过时是一个占位的 EOF
+  const Token& Previous() const { return buffer_[current_ - 1]; }
+
+  // 调用方保证当前 token 不是 EOF
+  void Advance() {
+    if (++current_ == size_) {
+      buffer_[0] = buffer_[current_ - 1];
+      size_ = 1 + scanner_.NextTokens(&buffer_[1], kCapacity - 1);
+      current_ = 1;
+    }
+  }
+
+ private:
+  static constexpr size_t kCapacity = 256;
+
+  Scanner& scanner_;
+  std::vector<Token> buffer_;
+  size_t current_ = 1;
+  size_t size_ = 1;
+};
+
+}  // namespace lox
+
+#endif  // LOX_CORE_TOKEN_STREAM_H_
@@ -1,16 +1,41 @@
 #include <iostream>
 #include <cstdlib>
+#include <string>
 
 #include "lox_interpreter/core/lox.h"
 
+static void PrintUsage() {
+  std::cout << "Usage: lox_interpreter [-O] [--ic-stats] [--mem-stats] "
+               "[--backend=ast|closure] [script]"
+            << std::endl;
+}
+
 int main(int argc, char const *argv[]) {
-  if (argc > 2) {
-    std::cout << "Usage: lox_interpreter [script] [--demo]" << std::endl;
-    exit(64);
-  } else if (argc == 2) {
-    lox::Lox::Instance().RunFile(argv[1]);
+  std::string script;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-O") {
+      lox::Lox::Instance().set_optimize(true);
+    } else if (arg == "--ic-stats") {
+      lox::Lox::Instance().set_print_cache_stats(true);
+    } else if (arg == "--mem-stats") {
+      lox::Lox::Instance().set_print_memory_stats(true);
+    } else if (arg == "--backend=ast") {
+      lox::Lox::Instance().set_backend(lox::Backend::AST);
+    } else if (arg == "--backend=closure") {
+      lox::Lox::Instance().set_backend(lox::Backend::CLOSURE);
+    } else if (script.empty() && arg[0] != '-') {
+      script = arg;
+    } else {
+      PrintUsage();
+      exit(64);
+    }
+  }
+
+  if (!script.empty()) {
+    lox::Lox::Instance().RunFile(script);
   } else {
     lox::Lox::Instance().RunPrompt();
   }
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,18 @@
+#ifndef LOX_UTIL_COMPLETION_H_
+#define LOX_UTIL_COMPLETION_H_
+
+namespace lox {
+
+// 语句执行的完成信号，沿着 Execute 的返回值向外传递，
+// return / break 因此不需要经过 C++ 异常机制。
+// return 的返回值由解释器单独保存（Interpreter::return_value_），
+// 这样正常路径上只需要传递一个枚举值。
+enum class Completion {
+  NORMAL,  // 正常执行完毕
+  RETURN,  // 执行了 return，向外传递到函数调用处
+  BREAK,   // 执行了 break，向外传递到最近的循环
+};
+
+}  // namespace lox
+
+#endif  // LOX_UTIL_COMPLETION_H_
@@ -0,0 +1,134 @@
+#ifndef LOX_UTIL_INLINE_CACHE_H_
+#define LOX_UTIL_INLINE_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "lox_interpreter/util/shape.h"
+
+namespace lox {
+
+class FunctionCallable;
+
+// 挂在每个 GetExpr / SetExpr 节点上的内联缓存。
+//
+// 一个属性访问点在运行时通常只会见到一两种对象布局，缓存以
+// (Shape, 类 id) 为键记下上一次的查找结果：字段所在槽位、找到的方法
+// 或 getter，以及 Set 时新增字段的 Shape 转换。命中时直接按槽位读写，
+// 不再查字段表或沿父类链查方法表。同一访问点见到的布局超过
+// kMaxEntries 种后视为超多态（megamorphic），不再记录新条目。
+//
+// 命中/未命中只记在访问点自己身上，访问时不碰任何全局数据。所有访问点
+// 串在一条侵入式链表上，--ic-stats 打印时再逐个求和；访问点随语法树
+// 销毁时把计数并入已退役的累计值。
+class PropertyCache {
+ public:
+  static constexpr size_t kMaxEntries = 4;
+
+  enum class Kind : uint8_t {
+    FIELD,      // 已有字段，读写 slot
+    ADD_FIELD,  // Set 新增字段：转换到 new_shape，值写入 slot
+    METHOD,     // 绑定 method 后返回
+    GETTER,     // 绑定 method 后立即调用
+  };
+
+  struct Entry {
+    const Shape* shape;
+    uint64_t class_id;
+    Kind kind;
+    int slot;
+    Shape* new_shape;
+    // 方法由类的方法表持有。类被释放后它的 id 不会再出现，
+    // 条目也就不会再命中，因此这里不必持有所有权
+    FunctionCallable* method;
+  };
+
+  // 整个进程的累计命中情况，用于 --ic-stats
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t megamorphic_sites = 0;
+  };
+
+  PropertyCache() : next_(Sites()) {
+    if (next_ != nullptr) {
+      next_->prev_ = this;
+    }
+    Sites() = this;
+  }
+
+  // 链表里存的是访问点的地址，不能复制或移动
+  PropertyCache(const PropertyCache&) = delete;
+  PropertyCache& operator=(const PropertyCache&) = delete;
+
+  ~PropertyCache() {
+    Retired().hits += hits_;
+    Retired().misses += misses_;
+    Retired().megamorphic_sites += megamorphic_;
+    if (prev_ != nullptr) {
+      prev_->next_ = next_;
+    } else {
+      Sites() = next_;
+    }
+    if (next_ != nullptr) {
+      next_->prev_ = prev_;
+    }
+  }
+
+  // 已销毁和仍存活的所有访问点的计数之和
+  static Stats CollectStats() {
+    Stats stats = Retired();
+    for (const PropertyCache* site = Sites(); site != nullptr;
+         site = site->next_) {
+      stats.hits += site->hits_;
+      stats.misses += site->misses_;
+      stats.megamorphic_sites += site->megamorphic_;
+    }
+    return stats;
+  }
+
+  const Entry* Find(const Shape* shape, uint64_t class_id) {
+    for (const Entry& entry : entries_) {
+      if (entry.shape == shape && entry.class_id == class_id) {
+        hits_++;
+        return &entry;
+      }
+    }
+    misses_++;
+    return nullptr;
+  }
+
+  void Add(const Entry& entry) {
+    if (entries_.size() == kMaxEntries) {
+      megamorphic_ = true;
+      return;
+    }
+    entries_.push_back(entry);
+  }
+
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+  bool megamorphic() const { return megamorphic_; }
+
+ private:
+  static PropertyCache*& Sites() {
+    static PropertyCache* head = nullptr;
+    return head;
+  }
+
+  static Stats& Retired() {
+    static Stats stats;
+    return stats;
+  }
+
+  std::vector<Entry> entries_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  bool megamorphic_ = false;
+  PropertyCache* prev_ = nullptr;
+  PropertyCache* next_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_UTIL_INLINE_CACHE_H_
@@ -6,7 +6,7 @@
 
 #include "lox_interpreter/util/lox_object.h"
 #include "lox_interpreter/ast/visitors/interpreter.h"
-#include "lox_interpreter/util/return_exception.h"
+#include "lox_interpreter/core/call_stack.h"
 // #include <memory>
 
 namespace lox {
@@ -19,18 +19,23 @@ class LoxCallable {
  public:
   // virtual LoxCallable() = default;
   virtual ~LoxCallable() = default;
-  virtual LoxObject operator()(Interpreter& interpreter,
-                               std::vector<LoxObject> arguments) = 0;
+  // 调用方已把 arity() 个实参依次压在解释器值栈 arguments 开始的槽位上
+  virtual LoxObject operator()(Interpreter& interpreter, size_t arguments) = 0;
   virtual size_t arity() = 0;
   virtual std::string ToString() = 0;
 };
 
-class ClockCallable : public LoxCallable {
+// LoxObject 以 CALLABLE 标记装箱的对象（用户函数和内置函数）的基类。
+// LoxObject 里只存对象的 RefCounted 地址，有了这个共同的类型，取
+// LoxCallable 时一次静态转换就够了，不需要按具体类型分支或 dynamic_cast
+class CallableObject : public LoxCallable, public Collectable {};
+
+// 内置函数不持有其他对象，Trace 和 ClearReferences 什么都不做
+class ClockCallable : public CallableObject {
  public:
   ClockCallable() = default;
   ~ClockCallable() = default;
-  LoxObject operator()(Interpreter& interpreter,
-                       std::vector<LoxObject> arguments) override {
+  LoxObject operator()(Interpreter& interpreter, size_t arguments) override {
     (void)interpreter;
     (void)arguments;
     return LoxObject(
@@ -39,61 +44,83 @@ class ClockCallable : public LoxCallable {
   }
   size_t arity() override { return 0; }
   std::string ToString() override { return "<fn clock()>"; }
+  void Trace(std::vector<Collectable*>& children) const override {
+    (void)children;
+  }
+  void ClearReferences() override {}
 };
 
-class FunctionCallable : public LoxCallable {
+class FunctionCallable : public CallableObject {
  public:
-  FunctionCallable(FunctionStmt&& function_stmt,
-                   std::shared_ptr<Environment> closure, bool is_initializer)
-      : function_stmt_(
-            std::make_shared<FunctionStmt>(std::move(function_stmt))),
-        closure_(std::move(closure)),
-        is_initializer_(is_initializer) {}
-
-  // 使用已有的函数声明指针（用于 Bind 创建的新函数对象）
-  FunctionCallable(std::shared_ptr<FunctionStmt> function_stmt,
-                   std::shared_ptr<Environment> closure, bool is_initializer)
-      : function_stmt_(std::move(function_stmt)),
-        closure_(std::move(closure)),
-        is_initializer_(is_initializer) {}
+  // function_stmt 归解释器保存的 AST 所有，这里只引用不拥有。
+  // upvalues 是创建闭包时捕获的外层变量，顺序与 function_stmt->upvalues_
+  // 一致。方法（is_method）调用时 this 紧跟在参数之后
+  FunctionCallable(const FunctionStmt* function_stmt, Upvalues upvalues,
+                   bool is_initializer, bool is_method = false,
+                   LoxObject receiver = nullptr)
+      : function_stmt_(function_stmt),
+        upvalues_(std::move(upvalues)),
+        is_initializer_(is_initializer),
+        is_method_(is_method),
+        receiver_(std::move(receiver)) {}
 
   ~FunctionCallable() = default;
-  LoxObject operator()(Interpreter& interpreter,
-                       std::vector<LoxObject> arguments) override {
-    auto environment = std::make_shared<Environment>(closure_);
-    for (size_t i = 0; i < function_stmt_->parameters_.size(); i++) {
-      environment->Define(function_stmt_->parameters_[i].lexeme(),
-                          arguments[i]);
+  LoxObject operator()(Interpreter& interpreter, size_t arguments) override {
+    return Call(interpreter, receiver_, arguments);
+  }
+
+  // 以 receiver 作为 this 调用方法。obj.method(...) 和 getter 直接走这里，
+  // 不需要先 Bind 出一个临时的方法对象。实参所在的槽位就是新栈帧的开头
+  LoxObject Call(Interpreter& interpreter, const LoxObject& receiver,
+                 size_t arguments) {
+    Completion completion = interpreter.ExecuteFunction(
+        *function_stmt_, upvalues_, is_method_ ? &receiver : nullptr,
+        arguments);
+    // 初始化方法总是返回 this，无论是否显式 return
+    if (is_initializer_) {
+      return receiver;
     }
-    try {
-      interpreter.ExecuteBlock(function_stmt_->body_, environment);
-    } catch (const ReturnException& return_exception) {
-      if (is_initializer_) {
-        return closure_->GetAt("this", 0);
-      }
-      return return_exception.value_;
+    if (completion == Completion::RETURN) {
+      return std::move(interpreter.return_value_);
     }
     return nullptr;
   }
 
+  LoxObject Call(Interpreter& interpreter, const LoxObject& receiver) {
+    return Call(interpreter, receiver, interpreter.sp_);
+  }
+
   size_t arity() override { return function_stmt_->parameters_.size(); }
 
   std::string ToString() override {
-    return "<fn " + function_stmt_->name_.lexeme() + "()>";
+    return "<fn " + std::string(function_stmt_->name_.lexeme()) + "()>";
+  }
+
+  void Trace(std::vector<Collectable*>& children) const override {
+    for (const auto& upvalue : upvalues_) {
+      children.push_back(upvalue.get());
+    }
+    Heap::Trace(receiver_, children);
+  }
+
+  void ClearReferences() override {
+    upvalues_.clear();
+    receiver_ = nullptr;
   }
 
-  std::shared_ptr<FunctionCallable> Bind(LoxObject instance) {
-    std::shared_ptr<Environment> environment =
-        std::make_shared<Environment>(closure_);
-    environment->Define("this", instance);
-    return std::make_shared<FunctionCallable>(function_stmt_, environment,
-                                              is_initializer_);
+  // 方法被当作值取出（如 var f = obj.method;）时才需要绑定
+  Ref<FunctionCallable> Bind(LoxObject instance) {
+    return MakeRef<FunctionCallable>(
+        function_stmt_, upvalues_, is_initializer_, true, std::move(instance));
   }
 
  private:
-  std::shared_ptr<FunctionStmt> function_stmt_;
-  std::shared_ptr<Environment> closure_;
+  const FunctionStmt* function_stmt_;
+  Upvalues upvalues_;
   bool is_initializer_ = false;
+  bool is_method_ = false;
+  // Bind 得到的方法对象记住的 this
+  LoxObject receiver_;
 };
 
 }  // namespace lox
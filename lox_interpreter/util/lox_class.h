@@ -1,6 +1,7 @@
 #ifndef LOX_UTIL_LOX_CLASS_H_
 #define LOX_UTIL_LOX_CLASS_H_
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -10,140 +11,158 @@
 
 namespace lox {
 
+// 方法名（驻留后的符号）到方法的映射
+using MethodTable =
+    std::unordered_map<Symbol, Ref<FunctionCallable>>;
+
 class LoxClass : public LoxCallable, public LoxInstance {
  public:
-  LoxClass(std::string name) : LoxInstance(nullptr), name_(std::move(name)) {}
-
-  LoxClass(std::string name, std::shared_ptr<LoxClass> super_class,
-           std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-               methods,
-           std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-               static_methods = {},
-           std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-               getters = {},
-           std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-               static_getters = {})
+  LoxClass(std::string name)
+      : LoxInstance(nullptr), id_(NextId()), name_(std::move(name)) {}
+
+  // 创建时把父类（已经展开过的）方法表复制进来，自己定义的同名成员
+  // 覆盖继承来的，此后查找只需一次哈希，与继承层数无关
+  LoxClass(std::string name, Ref<LoxClass> super_class,
+           MethodTable methods, MethodTable static_methods = {},
+           MethodTable getters = {}, MethodTable static_getters = {})
       : LoxInstance(nullptr),
+        id_(NextId()),
         name_(std::move(name)),
         super_class_(std::move(super_class)),
         methods_(std::move(methods)),
         static_methods_(std::move(static_methods)),
         getters_(std::move(getters)),
-        static_getters_(std::move(static_getters)) {}
+        static_getters_(std::move(static_getters)) {
+    if (super_class_ != nullptr) {
+      Inherit(methods_, super_class_->methods_);
+      Inherit(static_methods_, super_class_->static_methods_);
+      Inherit(getters_, super_class_->getters_);
+      Inherit(static_getters_, super_class_->static_getters_);
+    }
+    static const Symbol kInit = Symbol::Intern("init");
+    initializer_ = FindMethod(kInit);
+  }
 
   ~LoxClass() override = default;
 
+  // 类自身的静态字段之外，还持有父类和各个方法表
+  void Trace(std::vector<Collectable*>& children) const override {
+    LoxInstance::Trace(children);
+    if (super_class_ != nullptr) {
+      children.push_back(super_class_.get());
+    }
+    for (const MethodTable* table :
+         {&methods_, &static_methods_, &getters_, &static_getters_}) {
+      for (const auto& [name, method] : *table) {
+        children.push_back(method.get());
+      }
+    }
+  }
+
+  void ClearReferences() override {
+    LoxInstance::ClearReferences();
+    super_class_.reset();
+    methods_.clear();
+    static_methods_.clear();
+    getters_.clear();
+    static_getters_.clear();
+    initializer_ = nullptr;
+  }
+
   std::string name() const { return name_; }
 
+  // 进程内唯一、永不复用的类编号，作为内联缓存的键。
+  // 不直接用地址，是为了避免类被释放后新类复用同一地址导致缓存误命中
+  uint64_t id() const { return id_; }
+
   std::string ToString() override { return "<class " + name_ + ">"; }
 
   size_t arity() override {
-    std::shared_ptr<FunctionCallable> init_method = FindMethod("init");
-    if (init_method != nullptr) {
-      return init_method->arity();
-    }
-    return 0;
+    return initializer_ != nullptr ? initializer_->arity() : 0;
   }
 
-  LoxObject operator()(Interpreter& interpreter,
-                       std::vector<LoxObject> arguments) override {
+  LoxObject operator()(Interpreter& interpreter, size_t arguments) override {
     // 使用当前类对象（包含所有方法）来创建实例
-    std::shared_ptr<LoxInstance> instance =
-        std::make_shared<LoxInstance>(SelfAsClass());
-    std::shared_ptr<FunctionCallable> init_method = FindMethod("init");
-    if (init_method != nullptr) {
-      std::shared_ptr<FunctionCallable> bound_init =
-          init_method->Bind(LoxObject(instance));
-      (*bound_init)(interpreter, arguments);
+    Ref<LoxInstance> instance = MakeRef<LoxInstance>(SelfAsClass());
+    if (initializer_ != nullptr) {
+      initializer_->Call(interpreter, LoxObject(instance), arguments);
     }
     return LoxObject(instance);
   }
 
-  std::shared_ptr<FunctionCallable> FindMethod(const std::string& name) {
-    if (methods_.find(name) != methods_.end()) {
-      return methods_.at(name);
-    }
-    if (super_class_ != nullptr) {
-      return super_class_->FindMethod(name);
-    }
-    return nullptr;
+  // 以下查找返回的指针由方法表持有，与类同生命周期
+  FunctionCallable* FindMethod(Symbol name) const {
+    return Find(methods_, name);
   }
 
-  std::shared_ptr<FunctionCallable> FindStaticMethod(const std::string& name) {
-    if (static_methods_.find(name) != static_methods_.end()) {
-      return static_methods_.at(name);
-    }
-    if (super_class_ != nullptr) {
-      return super_class_->FindStaticMethod(name);
-    }
-    return nullptr;
+  FunctionCallable* FindStaticMethod(Symbol name) const {
+    return Find(static_methods_, name);
   }
 
-  std::shared_ptr<FunctionCallable> FindGetter(const std::string& name) {
-    if (getters_.find(name) != getters_.end()) {
-      return getters_.at(name);
-    }
-    if (super_class_ != nullptr) {
-      return super_class_->FindGetter(name);
-    }
-    return nullptr;
+  FunctionCallable* FindGetter(Symbol name) const {
+    return Find(getters_, name);
   }
 
-  std::shared_ptr<FunctionCallable> FindStaticGetter(const std::string& name) {
-    if (static_getters_.find(name) != static_getters_.end()) {
-      return static_getters_.at(name);
-    }
-    if (super_class_ != nullptr) {
-      return super_class_->FindStaticGetter(name);
-    }
-    return nullptr;
+  FunctionCallable* FindStaticGetter(Symbol name) const {
+    return Find(static_getters_, name);
   }
 
   // Override Get: for a class object, look up static getters and static
   // methods. Fields (set on the class) take priority.
-  LoxObject Get(Token name, Interpreter& interpreter) override {
+  LoxObject Get(const Token& name, Interpreter& interpreter) override {
     // 1. Check fields (allows setting arbitrary properties on the class)
-    if (fields_.find(name.lexeme()) != fields_.end()) {
-      return fields_.at(name.lexeme());
+    if (const LoxObject* field = FindField(name.symbol())) {
+      return *field;
     }
 
     // 2. Check static getters — auto-invoke, return result
-    std::shared_ptr<FunctionCallable> static_getter =
-        FindStaticGetter(name.lexeme());
+    FunctionCallable* static_getter = FindStaticGetter(name.symbol());
     if (static_getter != nullptr) {
-      std::shared_ptr<FunctionCallable> bound_getter =
-          static_getter->Bind(LoxObject(SelfAsClass()));
-      return (*bound_getter)(interpreter, {});
+      return static_getter->Call(interpreter, LoxObject(SelfAsClass()));
     }
 
     // 3. Check static methods — bind and return callable
-    std::shared_ptr<FunctionCallable> static_method =
-        FindStaticMethod(name.lexeme());
+    FunctionCallable* static_method = FindStaticMethod(name.symbol());
     if (static_method != nullptr) {
-      std::shared_ptr<FunctionCallable> bound_method =
+      Ref<FunctionCallable> bound_method =
           static_method->Bind(LoxObject(SelfAsClass()));
       return LoxObject(bound_method);
     }
 
-    throw RuntimeError(name,
-                       "Undefined static property '" + name.lexeme() + "'.");
+    throw RuntimeError(name, "Undefined static property '" +
+                                 std::string(name.lexeme()) + "'.");
   }
 
  private:
-  // Get shared_ptr<LoxClass> to self via the single enable_shared_from_this
-  // base (LoxInstance).
-  std::shared_ptr<LoxClass> SelfAsClass() {
-    return std::static_pointer_cast<LoxClass>(shared_from_this());
+  static void Inherit(MethodTable& own, const MethodTable& inherited) {
+    for (const auto& [name, method] : inherited) {
+      own.emplace(name, method);  // 不覆盖子类自己定义的
+    }
+  }
+
+  static FunctionCallable* Find(const MethodTable& table, Symbol name) {
+    auto it = table.find(name);
+    return it != table.end() ? it->second.get() : nullptr;
+  }
+
+  // 引用计数在对象内部，可以直接从 this 得到新的句柄
+  Ref<LoxClass> SelfAsClass() { return Ref<LoxClass>(this); }
+
+  // 编号从 1 开始，0 留给不区分类的缓存条目
+  static uint64_t NextId() {
+    static uint64_t next_id = 0;
+    return ++next_id;
   }
 
+  uint64_t id_;
   std::string name_;
-  std::shared_ptr<LoxClass> super_class_;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>> methods_;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-      static_methods_;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>> getters_;
-  std::unordered_map<std::string, std::shared_ptr<FunctionCallable>>
-      static_getters_;
+  Ref<LoxClass> super_class_;
+  MethodTable methods_;
+  MethodTable static_methods_;
+  MethodTable getters_;
+  MethodTable static_getters_;
+  // 缓存的 init 方法（含继承来的），没有时为 nullptr
+  FunctionCallable* initializer_ = nullptr;
 };
 }  // namespace lox
 
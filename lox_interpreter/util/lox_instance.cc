@@ -3,39 +3,126 @@
 
 namespace lox {
 
-LoxInstance::LoxInstance(std::shared_ptr<LoxClass> klass)
+LoxInstance::LoxInstance(Ref<LoxClass> klass)
     : klass_(std::move(klass)) {}
 
 std::string LoxInstance::ToString() { return klass_->name() + " instance"; }
 
-LoxObject LoxInstance::Get(Token name, Interpreter& interpreter) {
+void LoxInstance::Trace(std::vector<Collectable*>& children) const {
+  if (klass_ != nullptr) {
+    children.push_back(klass_.get());
+  }
+  for (const LoxObject& field : fields_) {
+    Heap::Trace(field, children);
+  }
+}
+
+void LoxInstance::ClearReferences() {
+  klass_.reset();
+  shape_ = Shape::Root();
+  fields_.clear();
+}
+
+LoxObject LoxInstance::Get(const Token& name, Interpreter& interpreter) {
+  return ApplyGet(ResolveGet(name), interpreter);
+}
+
+void LoxInstance::Set(const Token& name, LoxObject value) {
+  ApplySet(ResolveSet(name), std::move(value));
+}
+
+LoxObject LoxInstance::Get(const Token& name, Interpreter& interpreter,
+                           PropertyCache& cache) {
+  return ApplyGet(Lookup(name, cache), interpreter);
+}
+
+PropertyCache::Entry LoxInstance::Lookup(const Token& name,
+                                         PropertyCache& cache) {
+  if (const PropertyCache::Entry* entry = cache.Find(shape_, klass_->id())) {
+    return *entry;
+  }
+  PropertyCache::Entry entry = ResolveGet(name);
+  cache.Add(entry);
+  return entry;
+}
+
+void LoxInstance::Set(const Token& name, LoxObject value,
+                      PropertyCache& cache) {
+  // 写字段与类无关，只按 Shape 缓存
+  if (const PropertyCache::Entry* entry = cache.Find(shape_, 0)) {
+    ApplySet(*entry, std::move(value));
+    return;
+  }
+  PropertyCache::Entry entry = ResolveSet(name);
+  cache.Add(entry);
+  ApplySet(entry, std::move(value));
+}
+
+PropertyCache::Entry LoxInstance::ResolveGet(const Token& name) const {
+  PropertyCache::Entry entry{shape_, klass_->id(), PropertyCache::Kind::FIELD,
+                             -1, nullptr, nullptr};
+
   // 1. Check fields (highest priority — allows shadowing)
-  if (fields_.find(name.lexeme()) != fields_.end()) {
-    return fields_.at(name.lexeme());
+  entry.slot = shape_->Lookup(name.symbol());
+  if (entry.slot >= 0) {
+    return entry;
   }
 
   // 2. Check getters — auto-invoke and return result
-  std::shared_ptr<FunctionCallable> getter = klass_->FindGetter(name.lexeme());
-  if (getter != nullptr) {
-    std::shared_ptr<FunctionCallable> bound_getter =
-        getter->Bind(LoxObject(shared_from_this()));
-    return (*bound_getter)(interpreter, {});
+  entry.method = klass_->FindGetter(name.symbol());
+  if (entry.method != nullptr) {
+    entry.kind = PropertyCache::Kind::GETTER;
+    return entry;
   }
 
   // 3. Check methods — bind and return callable
-  std::shared_ptr<FunctionCallable> method = klass_->FindMethod(name.lexeme());
-  if (method != nullptr) {
-    // 绑定 this，得到一个新的方法对象
-    std::shared_ptr<FunctionCallable> bound_method =
-        method->Bind(LoxObject(shared_from_this()));
-    return LoxObject(bound_method);
+  entry.method = klass_->FindMethod(name.symbol());
+  if (entry.method != nullptr) {
+    entry.kind = PropertyCache::Kind::METHOD;
+    return entry;
   }
 
-  throw RuntimeError(name, "Undefined property '" + name.lexeme() + "'.");
+  throw RuntimeError(
+      name, "Undefined property '" + std::string(name.lexeme()) + "'.");
 }
 
-void LoxInstance::Set(Token name, LoxObject value) {
-  fields_[name.lexeme()] = value;
+LoxObject LoxInstance::ApplyGet(const PropertyCache::Entry& entry,
+                                Interpreter& interpreter) {
+  switch (entry.kind) {
+    case PropertyCache::Kind::FIELD:
+      return fields_[entry.slot];
+    case PropertyCache::Kind::GETTER: {
+      return entry.method->Call(interpreter, LoxObject(SelfAsInstance()));
+    }
+    default: {
+      // 绑定 this，得到一个新的方法对象
+      Ref<FunctionCallable> bound_method =
+          entry.method->Bind(LoxObject(SelfAsInstance()));
+      return LoxObject(bound_method);
+    }
+  }
+}
+
+PropertyCache::Entry LoxInstance::ResolveSet(const Token& name) const {
+  PropertyCache::Entry entry{shape_, 0, PropertyCache::Kind::FIELD, -1,
+                             nullptr, nullptr};
+  entry.slot = shape_->Lookup(name.symbol());
+  if (entry.slot < 0) {
+    entry.kind = PropertyCache::Kind::ADD_FIELD;
+    entry.slot = static_cast<int>(shape_->size());
+    entry.new_shape = shape_->AddField(name.symbol());
+  }
+  return entry;
+}
+
+void LoxInstance::ApplySet(const PropertyCache::Entry& entry,
+                           LoxObject value) {
+  if (entry.kind == PropertyCache::Kind::ADD_FIELD) {
+    shape_ = entry.new_shape;
+    fields_.push_back(std::move(value));
+  } else {
+    fields_[entry.slot] = std::move(value);
+  }
 }
 
 }  // namespace lox
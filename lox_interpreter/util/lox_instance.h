@@ -1,32 +1,69 @@
 #ifndef LOX_UTIL_LOX_INSTANCE_H_
 #define LOX_UTIL_LOX_INSTANCE_H_
 
-#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "lox_interpreter/util/lox_object.h"
+#include "lox_interpreter/core/heap.h"
+#include "lox_interpreter/core/pool.h"
+#include "lox_interpreter/core/symbol.h"
 #include "lox_interpreter/core/token.h"
+#include "lox_interpreter/util/inline_cache.h"
+#include "lox_interpreter/util/shape.h"
 
 namespace lox {
 
 class LoxClass;
 class Interpreter;
 
-class LoxInstance : public std::enable_shared_from_this<LoxInstance> {
+class LoxInstance : public Collectable {
  public:
-  LoxInstance(std::shared_ptr<LoxClass> klass);
+  LoxInstance(Ref<LoxClass> klass);
   virtual ~LoxInstance() = default;
 
   virtual std::string ToString();
 
-  virtual LoxObject Get(Token name, Interpreter& interpreter);
+  virtual LoxObject Get(const Token& name, Interpreter& interpreter);
 
-  virtual void Set(Token name, LoxObject value);
+  virtual void Set(const Token& name, LoxObject value);
+
+  void Trace(std::vector<Collectable*>& children) const override;
+  void ClearReferences() override;
+
+  // 带内联缓存的版本，只用于普通实例（类对象的静态成员不走缓存）
+  LoxObject Get(const Token& name, Interpreter& interpreter,
+                PropertyCache& cache);
+
+  void Set(const Token& name, LoxObject value, PropertyCache& cache);
+
+  // 查找属性（必要时更新缓存）但不取值，供解释器直接调用方法
+  PropertyCache::Entry Lookup(const Token& name, PropertyCache& cache);
+
+  // 按查找结果取值：读字段、调用 getter 或绑定方法
+  LoxObject ApplyGet(const PropertyCache::Entry& entry,
+                     Interpreter& interpreter);
 
  protected:
-  std::shared_ptr<LoxClass> klass_;
-  std::unordered_map<std::string, LoxObject> fields_;
+  // 字段的值，不存在时返回 nullptr（类对象查找静态字段时使用）
+  const LoxObject* FindField(Symbol name) const {
+    int slot = shape_->Lookup(name);
+    return slot >= 0 ? &fields_[slot] : nullptr;
+  }
+
+  // 查找属性（字段 → getter → 方法），结果以缓存条目的形式返回
+  PropertyCache::Entry ResolveGet(const Token& name) const;
+
+  PropertyCache::Entry ResolveSet(const Token& name) const;
+
+  Ref<LoxInstance> SelfAsInstance() { return Ref<LoxInstance>(this); }
+
+  void ApplySet(const PropertyCache::Entry& entry, LoxObject value);
+
+  Ref<LoxClass> klass_;
+  // 字段布局由共享的 shape_ 描述，fields_ 按槽位保存值
+  Shape* shape_ = Shape::Root();
+  std::vector<LoxObject, PoolAllocator<LoxObject>> fields_;
 };
 }  // namespace lox
 
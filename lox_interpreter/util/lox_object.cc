@@ -1,4 +1,4 @@
-#include <sstream>
+#include <charconv>
 #include <cmath>
 
 #include "lox_interpreter/util/lox_object.h"
@@ -8,43 +8,67 @@
 namespace lox {
 
 std::string LoxObject::ToString() const {
-  switch (value_.index()) {
+  switch (index()) {
     case TypeIndex::STRING:
-      return std::get<std::string>(value_);
+      return get<std::string>();
     case TypeIndex::NUMBER: {
-      double num = std::get<double>(value_);
-      // 检查是否为整数
-      if (std::floor(num) == num) {
-        return std::to_string(static_cast<long long>(num));
-      }
-      // 小数：使用ostringstream格式化，去掉尾部多余的0
-      std::ostringstream oss;
-      oss << num;
-      return oss.str();
+      char buffer[kNumberBufferSize];
+      return std::string(buffer, FormatNumber(asNumber(), buffer));
     }
     case TypeIndex::BOOLEAN:
-      return std::get<bool>(value_) ? "true" : "false";
+      return get<bool>() ? "true" : "false";
     case TypeIndex::NIL:
       return "nil";
     case TypeIndex::CALLABLE:
-      return std::get<std::shared_ptr<LoxCallable>>(value_)->ToString();
+      return get<LoxCallable>().ToString();
     case TypeIndex::CLASS:
-      return std::get<std::shared_ptr<LoxClass>>(value_)->ToString();
+      return get<LoxClass>().ToString();
     case TypeIndex::INSTANCE:
-      return std::get<std::shared_ptr<LoxInstance>>(value_)->ToString();
+      return get<LoxInstance>().ToString();
     default:
       return "";
   }
 }
 
+void LoxObject::AppendTo(std::string& out) const {
+  switch (index()) {
+    case TypeIndex::STRING:
+      out += asString().value();
+      break;
+    case TypeIndex::NUMBER: {
+      char buffer[kNumberBufferSize];
+      out.append(buffer, FormatNumber(asNumber(), buffer));
+      break;
+    }
+    default:
+      out += ToString();
+      break;
+  }
+}
+
+size_t LoxObject::FormatNumber(double num, char* buffer) {
+  char* end;
+  // 整数按整数输出：shortest 形式会把 1000000 写成 1e+06。
+  // 超过 long long 精度范围的值交给下面的浮点格式
+  if (std::floor(num) == num && std::fabs(num) < 1e18) {
+    end = std::to_chars(buffer, buffer + kNumberBufferSize,
+                        static_cast<long long>(num))
+              .ptr;
+  } else {
+    // 不指定格式和精度时输出能还原原值的最短形式
+    end = std::to_chars(buffer, buffer + kNumberBufferSize, num).ptr;
+  }
+  return end - buffer;
+}
+
 bool LoxObject::isTruthy() const {
-  switch (value_.index()) {
+  switch (index()) {
     case TypeIndex::STRING:
-      return !std::get<std::string>(value_).empty();
+      return !get<std::string>().empty();
     case TypeIndex::NUMBER:
-      return std::get<double>(value_) != 0.0;
+      return get<double>() != 0.0;
     case TypeIndex::BOOLEAN:
-      return std::get<bool>(value_);
+      return get<bool>();
     case TypeIndex::NIL:
       return false;
     case TypeIndex::CALLABLE:
@@ -59,7 +83,7 @@ bool LoxObject::isTruthy() const {
 }
 
 std::string LoxObject::typeName() const {
-  switch (value_.index()) {
+  switch (index()) {
     case TypeIndex::STRING:
       return "string";
     case TypeIndex::NUMBER:
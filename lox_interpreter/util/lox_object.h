@@ -1,28 +1,24 @@
 #ifndef LOX_UTIL_LOX_OBJECT_H_
 #define LOX_UTIL_LOX_OBJECT_H_
 
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <variant>
 #include <iostream>
 #include <memory>
 #include <type_traits>
 
+#include "lox_interpreter/util/ref.h"
+
 namespace lox {
 
 // 前向声明
+class CallableObject;
 class LoxCallable;
 class LoxClass;
 class LoxInstance;
 
-using LoxValue = std::variant<std::string,                   // string
-                              double,                        // number
-                              bool,                          // boolean
-                              std::nullptr_t,                // nil
-                              std::shared_ptr<LoxCallable>,  // callable
-                              std::shared_ptr<LoxClass>,     // class
-                              std::shared_ptr<LoxInstance>   // instance
-                              >;
-
 // type index constant
 namespace TypeIndex {
 constexpr size_t STRING = 0;
@@ -34,117 +30,189 @@ constexpr size_t CLASS = 5;
 constexpr size_t INSTANCE = 6;
 }  // namespace TypeIndex
 
-class LoxObject {
+// 堆上的不可变字符串。拷贝 LoxObject 只增加引用计数，不复制内容。
+// 哈希在第一次比较时算出并缓存，内容不可变，之后一直有效
+class LoxString : public RefCounted {
  public:
-  // constructor
-  LoxObject() : value_(nullptr) {}
+  explicit LoxString(std::string value) : value_(std::move(value)) {}
 
-  // constructor from various types
-  LoxObject(const std::string& str) : value_(str) {}
-  LoxObject(const char* str) : value_(std::string(str)) {}
-  LoxObject(double num) : value_(num) {}
-  LoxObject(int num) : value_(static_cast<double>(num)) {}
-  LoxObject(bool b) : value_(b) {}
-  LoxObject(std::nullptr_t) : value_(nullptr) {}
-  LoxObject(std::shared_ptr<LoxCallable> callable)
-      : value_(std::move(callable)) {}
-  LoxObject(std::shared_ptr<LoxClass> klass) : value_(std::move(klass)) {}
-  LoxObject(std::shared_ptr<LoxInstance> instance)
-      : value_(std::move(instance)) {}
-
-  // assignment operator
-  LoxObject& operator=(const std::string& str) {
-    value_ = str;
-    return *this;
+  // 一次分配好结果的空间，std::string 的 + 会先拷贝左边再扩容
+  static Ref<LoxString> Concat(const LoxString& left, const LoxString& right) {
+    std::string value;
+    value.reserve(left.size() + right.size());
+    value.append(left.value_).append(right.value_);
+    return MakeRef<LoxString>(std::move(value));
   }
 
-  LoxObject& operator=(const char* str) {
-    value_ = std::string(str);
-    return *this;
-  }
+  const std::string& value() const { return value_; }
+  size_t size() const { return value_.size(); }
 
-  LoxObject& operator=(double num) {
-    value_ = num;
-    return *this;
+  size_t Hash() const {
+    if (hash_ == 0) {
+      // 0 表示尚未计算
+      hash_ = std::hash<std::string>()(value_) | 1;
+    }
+    return hash_;
   }
 
-  LoxObject& operator=(int num) {
-    value_ = static_cast<double>(num);
-    return *this;
+  // 同一个对象、长度不同、哈希不同都不必逐字节比较
+  friend bool operator==(const LoxString& left, const LoxString& right) {
+    if (&left == &right) {
+      return true;
+    }
+    if (left.size() != right.size() || left.Hash() != right.Hash()) {
+      return false;
+    }
+    return left.value_ == right.value_;
   }
 
-  LoxObject& operator=(bool b) {
-    value_ = b;
-    return *this;
-  }
+ private:
+  const std::string value_;
+  mutable size_t hash_ = 0;
+};
 
-  LoxObject& operator=(std::nullptr_t) {
-    value_ = nullptr;
-    return *this;
-  }
+// LoxObject 只有 8 字节：一个 NaN-boxing 编码的 64 位值。
+//   - 数字：double 的原始位模式（NaN 统一规范化为 kCanonicalNaN）
+//   - 其他：落在 kNanBox 范围内的静默 NaN，最低 3 位是 TypeIndex
+//       * nil / bool：最高位为 0，拷贝时不碰引用计数
+//       * 字符串 / 可调用对象 / 类 / 实例：最高位置 1，中间 48 位是
+//         对象的 RefCounted 基类地址。拷贝和析构只比较 kHeapTag（负数
+//         的最高位也是 1，单看最高位会把负数当成指针），取出地址直接
+//         增减计数，不按类型分支；取值时再按类型标记静态转换到
+//         LoxString / CallableObject / LoxClass / LoxInstance
+// 引用计数是对象内的普通整数，拷贝和析构都不涉及原子操作。
+class LoxObject {
+ public:
+  // constructor
+  LoxObject() : LoxObject(nullptr) {}
 
-  LoxObject& operator=(std::shared_ptr<LoxCallable> callable) {
-    value_ = std::move(callable);
-    return *this;
+  // constructor from various types
+  LoxObject(const std::string& str) : LoxObject(MakeRef<LoxString>(str)) {}
+  LoxObject(std::string&& str)
+      : LoxObject(MakeRef<LoxString>(std::move(str))) {}
+  LoxObject(const char* str) : LoxObject(MakeRef<LoxString>(str)) {}
+  LoxObject(double num) : bits_(NumberBits(num)) {}
+  LoxObject(int num) : LoxObject(static_cast<double>(num)) {}
+  LoxObject(bool b) : bits_(BoolBits(b)) {}
+  LoxObject(std::nullptr_t) : bits_(kNil) {}
+
+  // 字符串、可调用对象、类和实例，类型标记在编译期按 T 确定
+  template <typename T>
+  LoxObject(const Ref<T>& object) : LoxObject(Ref<T>(object)) {}
+  template <typename T>
+  LoxObject(Ref<T>&& object) : bits_(BoxBits(object.Leak())) {}
+
+  LoxObject(const LoxObject& other) : bits_(other.bits_) {
+    if (RefCounted* counted = Counted()) {
+      counted->AddRef();
+    }
+  }
+  LoxObject(LoxObject&& other) noexcept : bits_(other.bits_) {
+    other.bits_ = kNil;
+  }
+  ~LoxObject() {
+    if (RefCounted* counted = Counted()) {
+      counted->Release();
+    }
   }
 
-  LoxObject& operator=(std::shared_ptr<LoxClass> klass) {
-    value_ = std::move(klass);
+  // 赋值统一走构造函数 + 默认的拷贝/移动赋值
+  template <typename T,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<T>, LoxObject> &&
+                std::is_constructible_v<LoxObject, T&&>>>
+  LoxObject& operator=(T&& value) {
+    return *this = LoxObject(std::forward<T>(value));
+  }
+  LoxObject& operator=(const LoxObject& other) {
+    if (RefCounted* counted = other.Counted()) {
+      counted->AddRef();
+    }
+    Replace(other.bits_);
     return *this;
   }
-  LoxObject& operator=(std::shared_ptr<LoxInstance> instance) {
-    value_ = std::move(instance);
+  LoxObject& operator=(LoxObject&& other) noexcept {
+    if (this != &other) {
+      Replace(other.bits_);
+      other.bits_ = kNil;
+    }
     return *this;
   }
 
   // get value (type safe)
+  // 字符串和对象类型返回引用，Ref<...> 返回与本对象共享所有权的新句柄；
+  // 类型不符时与 std::get 一样抛出 std::bad_variant_access
   template <typename T>
-  T get() const {
-    if constexpr (std::is_same_v<T, LoxCallable>) {
-      return *std::get<std::shared_ptr<LoxCallable>>(value_);
-    } else if constexpr (std::is_same_v<T, LoxClass>) {
-      return *std::get<std::shared_ptr<LoxClass>>(value_);
-    } else if constexpr (std::is_same_v<T, LoxInstance>) {
-      return *std::get<std::shared_ptr<LoxInstance>>(value_);
-    } else if constexpr (std::is_same_v<T, std::shared_ptr<LoxCallable>>) {
-      if (std::holds_alternative<std::shared_ptr<LoxCallable>>(value_)) {
-        return std::get<std::shared_ptr<LoxCallable>>(value_);
-      }
-      return std::static_pointer_cast<LoxCallable>(
-          std::get<std::shared_ptr<LoxClass>>(value_));
-    } else if constexpr (std::is_same_v<T, std::shared_ptr<LoxInstance>>) {
-      if (std::holds_alternative<std::shared_ptr<LoxInstance>>(value_)) {
-        return std::get<std::shared_ptr<LoxInstance>>(value_);
-      }
-      return std::static_pointer_cast<LoxInstance>(
-          std::get<std::shared_ptr<LoxClass>>(value_));
+  decltype(auto) get() const {
+    if (!is<GetTarget<T>>()) {
+      throw std::bad_variant_access();
+    }
+    if constexpr (std::is_same_v<T, double>) {
+      return asNumber();
+    } else if constexpr (std::is_same_v<T, bool>) {
+      bool b = Bits() == kTrue;
+      return b;
+    } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+      return nullptr;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      return asString().value();
+    } else if constexpr (std::is_same_v<T, CallableObject> ||
+                         std::is_same_v<T, LoxCallable> ||
+                         std::is_same_v<T, LoxClass> ||
+                         std::is_same_v<T, LoxInstance>) {
+      return static_cast<T&>(*ObjectPointer<T>());
     } else {
-      return std::get<T>(value_);
+      return T(ObjectPointer<typename T::element_type>());
     }
   }
 
+  // 调用方已确认 is<double>() 时使用，省掉 get<double>() 里的类型检查
+  double asNumber() const {
+    double num;
+    uint64_t bits = Bits();
+    std::memcpy(&num, &bits, sizeof(num));
+    return num;
+  }
+
+  // 调用方已确认 is<std::string>() 时使用
+  const LoxString& asString() const {
+    return *static_cast<const LoxString*>(Counted());
+  }
+
   // check type
   template <typename T>
   bool is() const {
-    if constexpr (std::is_same_v<T, LoxCallable>) {
-      return std::holds_alternative<std::shared_ptr<LoxCallable>>(value_) ||
-             std::holds_alternative<std::shared_ptr<LoxClass>>(value_);
-    } else if constexpr (std::is_same_v<T, LoxClass>) {
-      return std::holds_alternative<std::shared_ptr<LoxClass>>(value_);
+    if constexpr (std::is_same_v<T, double>) {
+      return (Bits() & kNanBox) != kNanBox;
+    } else if constexpr (std::is_same_v<T, LoxCallable>) {
+      return index() == TypeIndex::CALLABLE || index() == TypeIndex::CLASS;
     } else if constexpr (std::is_same_v<T, LoxInstance>) {
-      return std::holds_alternative<std::shared_ptr<LoxInstance>>(value_) ||
-             std::holds_alternative<std::shared_ptr<LoxClass>>(value_);
+      return index() == TypeIndex::INSTANCE || index() == TypeIndex::CLASS;
     } else {
-      return std::holds_alternative<T>(value_);
+      return index() == IndexOf<T>();
     }
   }
 
   // get index (faster)
-  size_t index() const { return value_.index(); }
+  size_t index() const {
+    uint64_t bits = Bits();
+    if ((bits & kNanBox) != kNanBox) {
+      return TypeIndex::NUMBER;
+    }
+    return bits & kTagMask;
+  }
 
   // convert to string(use constant to improve maintainability)
   std::string ToString() const;
 
+  // 把 ToString() 的结果追加到 out，字符串和数字不经过临时 std::string
+  void AppendTo(std::string& out) const;
+
+  // 数字的文本形式写入 buffer（至少 kNumberBufferSize 字节），返回长度。
+  // 整数按整数输出，其余按能精确还原原值的最短形式输出，不分配内存
+  static constexpr size_t kNumberBufferSize = 32;
+  static size_t FormatNumber(double num, char* buffer);
+
   // check if it is a truthy value
   bool isTruthy() const;
 
@@ -153,12 +221,16 @@ class LoxObject {
 
   // compare operator
   bool operator==(const LoxObject& other) const {
-    return value_ == other.value_;
+    if (is<double>() && other.is<double>()) {
+      return get<double>() == other.get<double>();
+    }
+    if (is<std::string>() && other.is<std::string>()) {
+      return asString() == other.asString();
+    }
+    return Bits() == other.Bits();
   }
 
-  bool operator!=(const LoxObject& other) const {
-    return value_ != other.value_;
-  }
+  bool operator!=(const LoxObject& other) const { return !(*this == other); }
 
   // output stream operator
   friend std::ostream& operator<<(std::ostream& os, const LoxObject& obj) {
@@ -167,9 +239,130 @@ class LoxObject {
   }
 
  private:
-  LoxValue value_;
+  // 第 50-62 位全为 1 的静默 NaN 用来装非数字的值，
+  // 硬件产生的 NaN（0x7ff8...）不会落进这个范围
+  static constexpr uint64_t kNanBox = 0x7ffc000000000000ULL;
+  static constexpr uint64_t kHeapBit = 0x8000000000000000ULL;
+  // 堆对象的完整标记。负数的最高位也是 1，必须连同 kNanBox 一起比较
+  static constexpr uint64_t kHeapTag = kHeapBit | kNanBox;
+  static constexpr uint64_t kTagMask = 0x7;
+  // 用户态地址只占低 48 位，堆对象至少 8 字节对齐
+  static constexpr uint64_t kPointerMask = 0x0000fffffffffff8ULL;
+  static constexpr uint64_t kCanonicalNaN = 0x7ff8000000000000ULL;
+  static constexpr uint64_t kNil = kNanBox | TypeIndex::NIL;
+  static constexpr uint64_t kFalse = kNanBox | TypeIndex::BOOLEAN;
+  static constexpr uint64_t kTrue = kNanBox | (1 << 3) | TypeIndex::BOOLEAN;
+
+  // get<Ref<X>> 按 X 做类型检查
+  template <typename T>
+  struct GetTargetImpl {
+    using type = T;
+  };
+  template <typename T>
+  struct GetTargetImpl<Ref<T>> {
+    using type = T;
+  };
+  template <typename T>
+  using GetTarget = typename GetTargetImpl<T>::type;
+
+  template <typename T>
+  static constexpr size_t IndexOf() {
+    if constexpr (std::is_same_v<T, std::string>) {
+      return TypeIndex::STRING;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return TypeIndex::BOOLEAN;
+    } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+      return TypeIndex::NIL;
+    } else if constexpr (std::is_same_v<T, CallableObject>) {
+      return TypeIndex::CALLABLE;
+    } else if constexpr (std::is_same_v<T, LoxClass>) {
+      return TypeIndex::CLASS;
+    } else {
+      static_assert(!sizeof(T*), "unsupported LoxObject type");
+      return 0;
+    }
+  }
+
+  static uint64_t NumberBits(double num) {
+    if (num != num) {
+      return kCanonicalNaN;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &num, sizeof(bits));
+    return bits;
+  }
+
+  static uint64_t BoolBits(bool b) { return b ? kTrue : kFalse; }
+
+  // 调用方已经为 bits 里的对象增加了一次计数，这里接管它并释放旧值
+  void Replace(uint64_t bits) {
+    RefCounted* old = Counted();
+    bits_ = bits;
+    if (old != nullptr) {
+      old->Release();
+    }
+  }
+
+  template <typename T>
+  static constexpr size_t TagOf() {
+    if constexpr (std::is_base_of_v<LoxString, T>) {
+      return TypeIndex::STRING;
+    } else if constexpr (std::is_base_of_v<LoxClass, T>) {
+      return TypeIndex::CLASS;
+    } else if constexpr (std::is_base_of_v<LoxInstance, T>) {
+      return TypeIndex::INSTANCE;
+    } else {
+      // LoxCallable 本身不带引用计数，可调用对象必须经由 CallableObject
+      static_assert(std::is_base_of_v<CallableObject, T>,
+                    "unsupported LoxObject type");
+      return TypeIndex::CALLABLE;
+    }
+  }
+
+  // 装箱的是 RefCounted 基类的地址，取值时按类型标记转换回来。
+  // 调用方已经为 object 增加了一次计数
+  template <typename T>
+  static uint64_t BoxBits(T* object) {
+    if (object == nullptr) {
+      return kNil;
+    }
+    const RefCounted* address = object;
+    return kHeapTag | reinterpret_cast<uintptr_t>(address) | TagOf<T>();
+  }
+
+  uint64_t Bits() const { return bits_; }
+
+  // 堆对象的 RefCounted 地址，其他值（包括负数）返回空，与类型无关
+  RefCounted* Counted() const {
+    return (bits_ & kHeapTag) == kHeapTag
+               ? reinterpret_cast<RefCounted*>(bits_ & kPointerMask)
+               : nullptr;
+  }
+
+  // Dependent 只用来推迟实例化，确保调用处 T 已经是完整类型
+  template <typename T, typename Dependent = void>
+  T* Downcast() const {
+    return static_cast<T*>(Counted());
+  }
+
+  template <typename T>
+  T* ObjectPointer() const {
+    if constexpr (std::is_same_v<T, LoxCallable>) {
+      // 类同时是可调用对象和实例，需要调整到对应的基类子对象
+      if (index() == TypeIndex::CLASS) {
+        return static_cast<T*>(Downcast<LoxClass, T>());
+      }
+      return static_cast<T*>(Downcast<CallableObject, T>());
+    } else {
+      return Downcast<T>();
+    }
+  }
+
+  uint64_t bits_;
 };
 
+static_assert(sizeof(LoxObject) == 8, "LoxObject should stay compact");
+
 }  // namespace lox
 
 #endif  // LOX_UTIL_LOX_OBJECT_H_
@@ -0,0 +1,125 @@
+#ifndef LOX_UTIL_REF_H_
+#define LOX_UTIL_REF_H_
+
+#include <cstddef>
+#include <utility>
+
+#include "lox_interpreter/core/pool.h"
+
+namespace lox {
+
+// 运行时对象（字符串、函数、类、实例、Cell）的侵入式引用计数基类。
+//
+// 解释器是单线程的，计数直接做普通的加减，不像 std::shared_ptr 那样
+// 每次拷贝都要一条带 lock 前缀的原子指令；计数就在对象里，也不需要
+// 单独的控制块和 enable_shared_from_this 的弱引用计数。
+// 对象只能通过 MakeRef 创建、由 Ref 持有，计数归零时 delete 自己。
+// 对象内存从当前的 ObjectPool 分配，同样大小的对象反复创建销毁时直接
+// 复用；释放时回到分配它的池。
+class RefCounted {
+ public:
+  RefCounted() = default;
+  RefCounted(const RefCounted&) = delete;
+  RefCounted& operator=(const RefCounted&) = delete;
+  virtual ~RefCounted() = default;
+
+  static void* operator new(size_t size) {
+    return ObjectPool::Current().Allocate(size);
+  }
+
+  // 析构函数是虚函数，size 是实际派生类的大小
+  static void operator delete(void* memory, size_t size) {
+    ObjectPool::Free(memory, size);
+  }
+
+  size_t ref_count() const { return ref_count_; }
+
+  void AddRef() { ++ref_count_; }
+
+  void Release() {
+    if (--ref_count_ == 0) {
+      delete this;
+    }
+  }
+
+ private:
+  size_t ref_count_ = 0;
+};
+
+// 持有一个 RefCounted 对象的句柄，用法与 std::shared_ptr 相同
+template <typename T>
+class Ref {
+ public:
+  using element_type = T;
+
+  Ref() = default;
+  Ref(std::nullptr_t) {}
+
+  // 对象自己持有计数，因此可以随时从裸指针（包括 this）得到新的句柄
+  explicit Ref(T* object) : object_(object) {
+    if (object_ != nullptr) {
+      object_->AddRef();
+    }
+  }
+
+  Ref(const Ref& other) : Ref(other.object_) {}
+  Ref(Ref&& other) noexcept : object_(other.object_) {
+    other.object_ = nullptr;
+  }
+
+  // 派生类句柄到基类句柄的转换
+  template <typename U>
+  Ref(const Ref<U>& other) : Ref(other.get()) {}
+  template <typename U>
+  Ref(Ref<U>&& other) noexcept : object_(other.Leak()) {}
+
+  ~Ref() {
+    if (object_ != nullptr) {
+      object_->Release();
+    }
+  }
+
+  Ref& operator=(Ref other) noexcept {
+    std::swap(object_, other.object_);
+    return *this;
+  }
+
+  T* get() const { return object_; }
+  T& operator*() const { return *object_; }
+  T* operator->() const { return object_; }
+  explicit operator bool() const { return object_ != nullptr; }
+
+  void reset() { *this = nullptr; }
+
+  // 交出所有权但不减计数
+  T* Leak() {
+    T* object = object_;
+    object_ = nullptr;
+    return object;
+  }
+
+  friend bool operator==(const Ref& ref, std::nullptr_t) {
+    return ref.object_ == nullptr;
+  }
+  friend bool operator!=(const Ref& ref, std::nullptr_t) {
+    return ref.object_ != nullptr;
+  }
+
+ private:
+  T* object_ = nullptr;
+};
+
+template <typename T, typename... Args>
+Ref<T> MakeRef(Args&&... args) {
+  return Ref<T>(new T(std::forward<Args>(args)...));
+}
+
+// 对应 std::static_pointer_cast
+template <typename T, typename U>
+Ref<T> StaticRefCast(const Ref<U>& ref) {
+  return Ref<T>(static_cast<T*>(ref.get()));
+}
+
+}  // namespace lox
+
+#endif  // LOX_UTIL_REF_H_
@@ -0,0 +1,30 @@
+#include "lox_interpreter/util/shape.h"
+
+namespace lox {
+
+Shape* Shape::Root() {
+  static Shape root;
+  return &root;
+}
+
+Shape::Shape(const Shape& parent, Symbol name) : fields_(parent.fields_) {
+  fields_.push_back(name);
+  if (fields_.size() > kLinearLookupLimit) {
+    for (size_t i = 0; i < fields_.size(); i++) {
+      index_.emplace(fields_[i], static_cast<int>(i));
+    }
+  }
+}
+
+Shape* Shape::AddField(Symbol name) {
+  for (auto& [field, next] : transitions_) {
+    if (field == name) {
+      return next.get();
+    }
+  }
+  transitions_.emplace_back(name,
+                            std::unique_ptr<Shape>(new Shape(*this, name)));
+  return transitions_.back().second.get();
+}
+
+}  // namespace lox
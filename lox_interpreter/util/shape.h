@@ -0,0 +1,62 @@
+#ifndef LOX_UTIL_SHAPE_H_
+#define LOX_UTIL_SHAPE_H_
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lox_interpreter/core/symbol.h"
+
+namespace lox {
+
+// 隐藏类（shape）：描述一个实例有哪些字段、各自存放在第几个槽位。
+//
+// 按相同顺序添加相同字段的实例共享同一个 Shape，实例本身只保存一个
+// Shape 指针和一段按槽位排列的值。所有 Shape 构成一棵以 Root() 为根的
+// 转换树：给实例添加新字段时沿着缓存的转换边走到子节点，只有第一次
+// 出现的字段序列才会创建新 Shape。Shape 一旦创建就不会释放，因此可以
+// 用裸指针比较身份（后续的内联缓存依赖这一点）。
+class Shape {
+ public:
+  // 没有任何字段的根 Shape
+  static Shape* Root();
+
+  // 返回字段所在的槽位，不存在时返回 -1
+  int Lookup(Symbol name) const {
+    if (!index_.empty()) {
+      auto it = index_.find(name);
+      return it != index_.end() ? it->second : -1;
+    }
+    // 字段不多时直接比较指针，比哈希更快
+    for (size_t i = 0; i < fields_.size(); i++) {
+      if (fields_[i] == name) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  // 在当前布局末尾追加一个字段后得到的 Shape，新字段的槽位是 size()
+  Shape* AddField(Symbol name);
+
+  size_t size() const { return fields_.size(); }
+
+  const std::vector<Symbol>& fields() const { return fields_; }
+
+ private:
+  // 字段数超过这个值时改用哈希表查找
+  static constexpr size_t kLinearLookupLimit = 8;
+
+  Shape() = default;
+  Shape(const Shape& parent, Symbol name);
+
+  std::vector<Symbol> fields_;
+  std::unordered_map<Symbol, int> index_;
+  // 大多数 Shape 只有一两条转换边，线性查找即可
+  std::vector<std::pair<Symbol, std::unique_ptr<Shape>>> transitions_;
+};
+
+}  // namespace lox
+
+#endif  // LOX_UTIL_SHAPE_H_
@@ -13,9 +13,9 @@ namespace test {
 
 static bool RunSource(const std::string& source, bool expect_success) {
   Scanner scanner(source);
-  auto tokens = scanner.ScanTokens();
 
-  Parser parser(tokens);
+  AstArena arena;
+  Parser parser(scanner, arena);
   auto statements = parser.Parse();
   if (Lox::Instance().HadError()) {
     Lox::Instance().ResetErrors();
@@ -0,0 +1,588 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lox_interpreter/core/scanner.h"
+#include "lox_interpreter/core/parser.h"
+#include "lox_interpreter/core/resolver.h"
+#include "lox_interpreter/core/heap.h"
+#include "lox_interpreter/core/pool.h"
+#include "lox_interpreter/core/lox.h"
+#include "lox_interpreter/ast/visitors/interpreter.h"
+#include "lox_interpreter/ast/visitors/optimizer.h"
+
+namespace lox {
+namespace test {
+
+// 执行方式：后端、节点派发方式、执行前是否先做 AST 优化
+struct Mode {
+  Backend backend;
+  Dispatch dispatch;
+  bool optimize;
+  const char* name;
+};
+
+// 运行一段源码，返回它打印到 std::cout 的全部内容（包括错误信息）
+static std::string RunAndCapture(const std::string& source, const Mode& mode) {
+  std::ostringstream output;
+  std::streambuf* original = std::cout.rdbuf(output.rdbuf());
+
+  Scanner scanner(source);
+  AstArena arena;
+  Parser parser(scanner, arena);
+  auto statements = parser.Parse();
+  if (!Lox::Instance().HadError()) {
+    Interpreter interpreter;
+    interpreter.set_backend(mode.backend);
+    interpreter.set_dispatch(mode.dispatch);
+    Resolver resolver(interpreter);
+    resolver.Resolve(statements);
+    if (!Lox::Instance().HadError()) {
+      if (mode.optimize) {
+        Optimizer optimizer(arena);
+        optimizer.Optimize(statements);
+      }
+      interpreter.Interpret(std::move(statements));
+    }
+  }
+  Lox::Instance().ResetErrors();
+
+  std::cout.rdbuf(original);
+  return output.str();
+}
+
+struct OutputCase {
+  std::string name;
+  std::string source;
+  std::string expected;
+};
+
+void testInterpreter() {
+  std::cout << "\n⚙️  解释器测试\n";
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
+
+  std::vector<OutputCase> tests;
+
+  // ============ return / break ============
+  tests.push_back({"递归函数返回值", R"(
+fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+print fib(10);
+)", "55\n"});
+
+  tests.push_back({"循环内 return 直接结束函数", R"(
+fun find(limit) {
+  var i = 0;
+  while (true) {
+    if (i * i > limit) return i;
+    i = i + 1;
+  }
+}
+print find(50);
+)", "8\n"});
+
+  tests.push_back({"break 只跳出最内层循环", R"(
+var total = 0;
+for (var i = 0; i < 3; i = i + 1) {
+  for (var j = 0; j < 10; j = j + 1) {
+    if (j == 2) break;
+    total = total + 1;
+  }
+}
+print total;
+)", "6\n"});
+
+  tests.push_back({"无 return 的函数返回 nil", R"(
+fun f() {}
+print f();
+)", "nil\n"});
+
+  tests.push_back({"init 总是返回 this", R"(
+class Box {
+  init(v) { this.v = v; }
+}
+var b = Box(1);
+print b.init(2) == b;
+print b.v;
+)", "true\n2\n"});
+
+  tests.push_back({"break 在循环外应报错", R"(
+break;
+)", "[line 2] Error at 'break': Can't use 'break' outside of a loop.\n"});
+
+  tests.push_back({"break 不能跨越函数边界", R"(
+while (true) {
+  fun f() { break; }
+}
+)", "[line 3] Error at 'break': Can't use 'break' outside of a loop.\n"});
+
+  // ============ 变量解析 ============
+  tests.push_back({"闭包捕获局部变量", R"(
+fun makeCounter() {
+  var i = 0;
+  fun count() { i = i + 1; return i; }
+  return count;
+}
+var a = makeCounter();
+var b = makeCounter();
+a();
+print a();
+print b();
+)", "2\n1\n"});
+
+  tests.push_back({"闭包在声明处静态绑定", R"(
+var x = "global";
+{
+  fun show() { print x; }
+  show();
+  var x = "local";
+  show();
+}
+)", "global\nglobal\n"});
+
+  tests.push_back({"每个子类的 super 指向自己的父类", R"(
+class A { name() { return "A"; } }
+class B < A { name() { return "B>" + super.name(); } }
+class C { name() { return "C"; } }
+class D < C { name() { return "D>" + super.name(); } }
+print B().name();
+print D().name();
+)", "B>A\nD>C\n"});
+
+  tests.push_back({"循环体中的闭包各自捕获本次迭代的变量", R"(
+var first;
+var second;
+for (var i = 0; i < 2; i = i + 1) {
+  var j = i;
+  fun show() { print j; }
+  if (i == 0) first = show; else second = show;
+}
+first();
+second();
+)", "0\n1\n"});
+
+  tests.push_back({"跨多层函数捕获参数、this 和 super", R"(
+fun adder(n) {
+  fun outer() { fun inner() { n = n + 1; return n; } return inner; }
+  return outer();
+}
+var add = adder(10);
+add();
+print add();
+class A { name() { return "A"; } }
+class B < A {
+  init() { this.tag = "!"; }
+  later() { fun f() { return super.name() + this.tag; } return f; }
+}
+print B().later()();
+{ var a = 1; { var b = 2; print a + b; } { var c = 3; print a + c; } }
+)", "12\nA!\n3\n4\n"});
+
+  // ============ 全局变量 ============
+  tests.push_back({"引用稍后才定义的全局函数", R"(
+fun isEven(n) { if (n == 0) return true; return isOdd(n - 1); }
+fun isOdd(n) { if (n == 0) return false; return isEven(n - 1); }
+print isEven(10);
+)", "true\n"});
+
+  tests.push_back({"全局变量可以重复定义", R"(
+var g = 1;
+var g = g + 1;
+print g;
+)", "2\n"});
+
+  tests.push_back({"读取未定义的全局变量应报错", R"(
+fun f() { return missing; }
+f();
+)", "[line 2] Runtime Error: Undefined variable 'missing'.\n"});
+
+  tests.push_back({"给未定义的全局变量赋值应报错", R"(
+missing = 1;
+)", "[line 2] Runtime Error: Undefined variable 'missing'.\n"});
+
+  // ============ 值表示 ============
+  tests.push_back({"字符串按内容比较，对象按身份比较", R"(
+class A {}
+var a = A();
+var b = a;
+print "ab" == "a" + "b";
+print a == b;
+print a == A();
+print nil == false;
+)", "true\ntrue\nfalse\nfalse\n"});
+
+  tests.push_back({"NaN 不等于自身", R"(
+var big = 1;
+for (var i = 0; i < 1100; i = i + 1) big = big * 2;
+var nan = big - big;
+print nan == nan;
+print big == big;
+)", "false\ntrue\n"});
+
+  tests.push_back({"数字按整数或最短往返形式输出", R"(
+print 1000000;
+print -2.5;
+print 0.1 + 0.2;
+print 1 / 3;
+print -0;
+)", "1000000\n-2.5\n0.30000000000000004\n0.3333333333333333\n0\n"});
+
+  // 负数的最高位与堆对象标记的最高位相同，拷贝、存取时不能被当成指针。
+  // -0.1 和 -3.7 的尾数低位不为 0，误当成指针时会访问非法地址
+  tests.push_back({"负小数的拷贝、存取与传参", R"(
+class Box { init(value) { this.value = value; } }
+fun identity(x) { return x; }
+var a = -0.1;
+var b = a;
+b = a;
+{
+  var local = -3.7;
+  var copy = local;
+  print copy;
+}
+var box = Box(-3.7);
+box.value = box.value;
+print box.value;
+print identity(a);
+print identity(-3.7) + identity(-0.1);
+fun make() { var captured = -0.1; fun get() { return captured; } return get; }
+print make()();
+print b;
+)", "-3.7\n-3.7\n-0.1\n-3.8000000000000003\n-0.1\n-0.1\n"});
+
+  // ============ 扫描 ============
+  // 标识符、字符串、注释和空白都长于一个 SIMD 块，其中的换行由块扫描
+  // 统计；最后一行的运行时错误检查行号
+  tests.push_back({"长词素与长空白之后行号正确", R"(
+var aVeryLongIdentifierThatSpansMoreThanOneBlock_0123456789 = "first line
+second line of a string that is longer than one block
+third";
+/* a block comment /* with a nested one */ that runs past one block *****
+   and continues on the next line with a // slash and a * star
+*/
+                                                               // spaces
+		      		      // tabs and spaces
+print aVeryLongIdentifierThatSpansMoreThanOneBlock_0123456789;
+print missing;
+)", "first line\nsecond line of a string that is longer than one block\n"
+      "third\n[line 11] Runtime Error: Undefined variable 'missing'.\n"});
+
+  // Parser 按批从 Scanner 拉取 token，长程序要跨过许多批的边界，
+  // 语法错误的行号也要对
+  std::string long_program = "var x = 0;\n";
+  for (int i = 0; i < 500; ++i) {
+    long_program += "x = x + (1);\n";
+  }
+  tests.push_back({"跨越多批 token 的长程序", long_program + "print x;\n",
+                   "500\n"});
+  tests.push_back({"长程序末尾的语法错误", long_program + "print x +;\n",
+                   "[line 502] Error at ';': Expect expression.\n"});
+
+  // ============ 属性查找 ============
+  tests.push_back({"字段优先于同名方法", R"(
+class P {
+  init() { this.size = 1; }
+  size() { return 2; }
+  grow() { this.size = this.size + 1; return this.size; }
+}
+var p = P();
+print p.grow();
+var name = "si" + "ze";
+print name == "size";
+)", "2\ntrue\n"});
+
+  tests.push_back({"字段添加顺序不同的实例互不干扰", R"(
+class P {}
+var a = P();
+a.x = 1; a.y = 2;
+var b = P();
+b.y = 3; b.x = 4;
+print a.x + a.y * 10;
+print b.x + b.y * 10;
+)", "21\n34\n"});
+
+  tests.push_back({"字段很多的实例", R"(
+class Bag {}
+var b = Bag();
+b.f0 = 0; b.f1 = 1; b.f2 = 2; b.f3 = 3; b.f4 = 4; b.f5 = 5;
+b.f6 = 6; b.f7 = 7; b.f8 = 8; b.f9 = 9; b.f10 = 10;
+b.f3 = 30;
+print b.f0 + b.f3 + b.f9 + b.f10;
+)", "49\n"});
+
+  // ============ 内联缓存 ============
+  tests.push_back({"同一访问点见到多种类和布局", R"(
+class A { name() { return "A"; } }
+class B { name() { return "B"; } }
+class C < A {}
+fun show(o) { print o.name(); }
+var a = A();
+var b = B();
+var c = C();
+var d = A();
+d.extra = 1;
+show(a); show(b); show(c); show(d); show(a);
+)", "A\nB\nA\nA\nA\n"});
+
+  tests.push_back({"超多态访问点仍然正确", R"(
+class K {}
+fun make(n) {
+  var o = K();
+  if (n == 0) o.v0 = 0;
+  if (n == 1) o.v1 = 1;
+  if (n == 2) o.v2 = 2;
+  if (n == 3) o.v3 = 3;
+  if (n == 4) o.v4 = 4;
+  if (n == 5) o.v5 = 5;
+  o.v = n;
+  return o;
+}
+var total = 0;
+for (var i = 0; i < 6; i = i + 1) total = total + make(i).v;
+for (var i = 0; i < 6; i = i + 1) total = total + make(i).v;
+print total;
+)", "30\n"});
+
+  tests.push_back({"缓存的方法被后加的同名字段遮蔽", R"(
+class P { f() { return "method"; } }
+fun get(o) { return o.f; }
+var p = P();
+print get(p)();
+p.f = "field";
+print get(p);
+)", "method\nfield\n"});
+
+  // ============ 方法调用 ============
+  tests.push_back({"方法调用与字段中的函数", R"(
+fun twice(x) { return x * 2; }
+class Box {
+  init(v) { this.v = v; this.f = twice; }
+  get() { return this.v; }
+  add(n) { return this.v + n; }
+}
+var b = Box(5);
+print b.get();
+print b.add(2);
+print b.f(3);
+var m = b.add;
+b.v = 10;
+print m(1);
+)", "5\n7\n6\n11\n"});
+
+  tests.push_back({"方法内的闭包捕获 this", R"(
+class Counter {
+  init() { this.n = 0; }
+  incrementer() {
+    fun inc() { this.n = this.n + 1; return this.n; }
+    return inc;
+  }
+}
+var c = Counter();
+var inc = c.incrementer();
+inc();
+print inc();
+print c.n;
+)", "2\n2\n"});
+
+  tests.push_back({"方法参数个数不符应报错", R"(
+class A { m(x) { return x; } }
+A().m(1, 2);
+)", "[line 3] Runtime Error: Expected 1 arguments but got 2\n"});
+
+  // ============ 继承 ============
+  tests.push_back({"多层继承的方法、初始化方法和静态方法", R"(
+class A {
+  init(n) { this.n = n; }
+  who() { return "A"; }
+  class make() { return this(7); }
+}
+class B < A { who() { return "B"; } }
+class C < B {}
+class D < C {}
+var d = D(3);
+print d.who();
+print d.n;
+print D.make().n;
+print A(1).who();
+)", "B\n3\n7\nA\n"});
+
+  // ============ 运算节点特化 ============
+  tests.push_back({"同一个 + 先见数字后见字符串", R"(
+fun add(a, b) { return a + b; }
+print add(1, 2);
+print add("a", "b");
+print add(3, 4);
+)", "3\nab\n7\n"});
+
+  tests.push_back({"特化为字符串的 == 遇到数字", R"(
+fun eq(a, b) { return a == b; }
+print eq("x", "x");
+print eq(1, 1);
+print eq("x", 1);
+)", "true\ntrue\nfalse\n"});
+
+  tests.push_back({"特化为数字的比较守卫失败时照常报错", R"(
+fun less(a, b) { return a < b; }
+print less(1, 2);
+less("a", 2);
+)", "true\n[line 2] Runtime Error: Operands must be numbers.\n"});
+
+  tests.push_back({"特化后的除法仍检查除零", R"(
+fun div(a, b) { return a / b; }
+print div(6, 3);
+div(1, 0);
+)", "2\n[line 2] Runtime Error: Division by zero.\n"});
+
+  // 报错前 print 的内容还在输出缓冲里，必须先写出来
+  tests.push_back({"对非数字取负报运行时错误", R"(
+print 1;
+print -"a";
+)", "1\n[line 3] Runtime Error: Operand must be a number.\n"});
+
+  tests.push_back({"特化为数字的取负守卫失败时照常报错", R"(
+fun negate(x) { return -x; }
+print negate(2);
+negate(nil);
+)", "-2\n[line 2] Runtime Error: Operand must be a number.\n"});
+
+  // ============ AST 优化（-O） ============
+  tests.push_back({"常量表达式与字符串拼接", R"(
+print (1 + 2) * -(3 - 5) / 4;
+print "con" + "fig" == "config";
+print !(1 < 2) or 3 >= 3;
+print nil and 1;
+)", "1.5\ntrue\ntrue\nnil\n"});
+
+  tests.push_back({"常量条件的 if / while", R"(
+if (1 > 2) print "dead"; else print "live";
+if (true) { var a = "block"; print a; }
+while (false) print "never";
+for (var i = 0; 1 > 2; i = i + 1) print i;
+var x = 1;
+print x;
+)", "live\nblock\n1\n"});
+
+  tests.push_back({"常量除零仍在运行时报错", R"(
+print "before";
+print 1 / (2 - 2);
+)", "before\n[line 3] Runtime Error: Division by zero.\n"});
+
+  tests.push_back({"常量类型不符仍在运行时报错", R"(
+print "a" + 1;
+)", "[line 2] Runtime Error: Operands must be numbers or strings.\n"});
+
+  int passed = 0;
+  int failed = 0;
+
+  // 每个用例在各种执行方式下各跑一遍，输出必须一致
+  const Mode modes[] = {
+      {Backend::AST, Dispatch::SWITCH, false, "AST"},
+      {Backend::AST, Dispatch::VIRTUAL, false, "AST 虚调用"},
+      {Backend::CLOSURE, Dispatch::SWITCH, false, "闭包"},
+      {Backend::AST, Dispatch::SWITCH, true, "AST -O"},
+  };
+  for (auto& t : tests) {
+    for (auto& mode : modes) {
+      std::cout << "  测试: " << t.name << " [" << mode.name << "]\n";
+      std::string actual = RunAndCapture(t.source, mode);
+      if (actual == t.expected) {
+        std::cout << "    ✅ 通过\n";
+        passed++;
+      } else {
+        std::cout << "    ❌ 失败\n      期望: " << t.expected
+                  << "      实际: " << actual;
+        failed++;
+      }
+    }
+  }
+
+  // ============ 环回收 ============
+  // 每次迭代都制造几种引用环：递归的局部函数（闭包经 Cell 引用自己）、
+  // 互相引用的实例、方法引用所在的局部类。存活对象数不能随迭代次数增长，
+  // 程序结束后也不能留下任何对象
+  const std::string cycles = R"(
+class Node { init() { this.self = this; } }
+var i = 0;
+while (i < 30000) {
+  fun make() {
+    fun loop() { return loop; }
+    var a = Node();
+    var b = Node();
+    a.other = b;
+    b.other = a;
+    a.fn = loop;
+    class Local { m() { return Local; } }
+    return a;
+  }
+  make();
+  i = i + 1;
+}
+print "done";
+)";
+  Heap& heap = Heap::Instance();
+  for (auto& mode : modes) {
+    std::cout << "  测试: 引用环被回收，堆不随迭代增长 [" << mode.name
+              << "]\n";
+    heap.Collect();
+    size_t baseline = heap.size();
+    heap.stats().peak = baseline;
+    std::string actual = RunAndCapture(cycles, mode);
+    heap.Collect();
+    if (actual == "done\n" && heap.size() == baseline &&
+        heap.stats().peak < baseline + 100000) {
+      std::cout << "    ✅ 通过\n";
+      passed++;
+    } else {
+      std::cout << "    ❌ 失败\n      输出: " << actual
+                << "      残留对象: " << heap.size() - baseline
+                << "，峰值: " << heap.stats().peak - baseline << "\n";
+      failed++;
+    }
+  }
+
+  // ============ 内存池 ============
+  // 对象从当前池分配，但总是释放回分配它的池；池销毁时还有对象存活的话，
+  // 池要留到这些对象释放之后（ASan 构建能发现释放后使用）
+  std::cout << "  测试: 对象释放回分配它的池\n";
+  {
+    ObjectPool::Handle first = ObjectPool::Create();
+    ObjectPool::Handle second = ObjectPool::Create();
+    Ref<LoxString> string;
+    {
+      ObjectPool::Scope scope(*first);
+      string = MakeRef<LoxString>("first");
+    }
+    bool ok = first->live() == 1 && second->live() == 0;
+    {
+      ObjectPool::Scope scope(*second);
+      string.reset();
+    }
+    ok = ok && first->live() == 0 && second->live() == 0;
+
+    {
+      ObjectPool::Scope scope(*first);
+      string = MakeRef<LoxString>("outlives its pool");
+    }
+    first.reset();
+    ok = ok && string->value() == "outlives its pool";
+    string.reset();
+    if (ok) {
+      std::cout << "    ✅ 通过\n";
+      passed++;
+    } else {
+      std::cout << "    ❌ 失败\n";
+      failed++;
+    }
+  }
+
+  std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+  std::cout << "解释器测试: " << passed << "/" << (passed + failed)
+            << " 通过\n";
+  if (failed > 0) {
+    throw std::runtime_error("解释器测试失败");
+  }
+}
+
+}  // namespace test
+}  // namespace lox
@@ -8,6 +8,7 @@ void testScanner();
 void testTokenType();
 void testPrinter();
 void testClass();
+void testInterpreter();
 }  // namespace test
 }  // namespace lox
 
@@ -20,7 +21,7 @@ void printUsage(const char* program) {
     std::cout << "  --printer       测试表达式打印器\n";
     std::cout << "  --class         测试类继承\n";
     // std::cout << "  --parser        测试Parser（语法分析器）\n";
-    // std::cout << "  --interpreter   测试Interpreter（解释器）\n";
+    std::cout << "  --interpreter   测试Interpreter（解释器）\n";
     std::cout << "  --help, -h      显示帮助信息\n";
     std::cout << "\n示例:\n";
     std::cout << "  " << program << " --all\n";
@@ -40,6 +41,7 @@ int main(int argc, char* argv[]) {
     bool runTokenType = false;
     bool runPrinter = false;
     bool runClass = false;
+    bool runInterpreter = false;
 
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -59,6 +61,8 @@ int main(int argc, char* argv[]) {
         runClass = true;
         } else if (arg == "--class") {
             runClass = true;
+        } else if (arg == "--interpreter") {
+            runInterpreter = true;
         } else {
             std::cout << "❌ 未知选项: " << arg << "\n\n";
             printUsage(argv[0]);
@@ -71,6 +75,7 @@ int main(int argc, char* argv[]) {
         runScanner = true;
         runTokenType = true;
         runPrinter = true;
+        runInterpreter = true;
     }
 
     std::cout << "🧪 Lox 测试套件\n";
@@ -135,6 +140,20 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // 运行Interpreter测试
+    if (runInterpreter) {
+        testCount++;
+        std::cout << "▶️  运行 Interpreter 测试...\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        try {
+            lox::test::testInterpreter();
+            std::cout << "✅ Interpreter 测试通过\n\n";
+            passedCount++;
+        } catch (const std::exception& e) {
+            std::cout << "❌ Interpreter 测试失败: " << e.what() << "\n\n";
+        }
+    }
+
     // 总结
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
     std::cout << "测试总结: " << passedCount << "/" << testCount << " 通过\n";
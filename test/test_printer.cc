@@ -13,52 +13,53 @@ void testPrinter() {
   std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
 
   Printer printer;
+  AstArena arena;
 
   // 测试 1: Literal 字面量
   std::cout << "测试 1: 字面量\n";
-  auto literal = std::make_unique<LiteralExpr>(LoxObject(123.1));
+  auto literal = arena.New<LiteralExpr>(LoxObject(123.1));
   std::cout << "  表达式: 123.1\n";
   std::cout << "  输出: " << printer.Print(*literal) << "\n\n";
 
   // 测试 2: Unary 一元表达式: -123
   std::cout << "测试 2: 一元表达式\n";
-  Token minus(TokenType::MINUS, "-", nullptr, 1);
-  auto unary = std::make_unique<UnaryExpr>(
+  Token minus(TokenType::MINUS, "-", 1);
+  auto unary = arena.New<UnaryExpr>(
       minus,
-      std::make_unique<LiteralExpr>(LoxObject(123.0))
+      arena.New<LiteralExpr>(LoxObject(123.0))
   );
   std::cout << "  表达式: -123\n";
   std::cout << "  输出: " << printer.Print(*unary) << "\n\n";
 
   // 测试 3: Binary 二元表达式: 1 + 2
   std::cout << "测试 3: 二元表达式\n";
-  Token plus(TokenType::PLUS, "+", nullptr, 1);
-  auto binary = std::make_unique<BinaryExpr>(
-      std::make_unique<LiteralExpr>(LoxObject(1.0)),
+  Token plus(TokenType::PLUS, "+", 1);
+  auto binary = arena.New<BinaryExpr>(
+      arena.New<LiteralExpr>(LoxObject(1.0)),
       plus,
-      std::make_unique<LiteralExpr>(LoxObject(2.0))
+      arena.New<LiteralExpr>(LoxObject(2.0))
   );
   std::cout << "  表达式: 1 + 2\n";
   std::cout << "  输出: " << printer.Print(*binary) << "\n\n";
 
   // 测试 4: 复杂表达式: (1 + 2) * (4 - 3)
   std::cout << "测试 4: 复杂表达式\n";
-  Token star(TokenType::STAR, "*", nullptr, 1);
-  Token minus2(TokenType::MINUS, "-", nullptr, 1);
-  auto complex = std::make_unique<BinaryExpr>(
-      std::make_unique<GroupingExpr>(
-          std::make_unique<BinaryExpr>(
-              std::make_unique<LiteralExpr>(LoxObject(1.0)),
+  Token star(TokenType::STAR, "*", 1);
+  Token minus2(TokenType::MINUS, "-", 1);
+  auto complex = arena.New<BinaryExpr>(
+      arena.New<GroupingExpr>(
+          arena.New<BinaryExpr>(
+              arena.New<LiteralExpr>(LoxObject(1.0)),
               plus,
-              std::make_unique<LiteralExpr>(LoxObject(2.0))
+              arena.New<LiteralExpr>(LoxObject(2.0))
           )
       ),
       star,
-      std::make_unique<GroupingExpr>(
-          std::make_unique<BinaryExpr>(
-              std::make_unique<LiteralExpr>(LoxObject(4.0)),
+      arena.New<GroupingExpr>(
+          arena.New<BinaryExpr>(
+              arena.New<LiteralExpr>(LoxObject(4.0)),
               minus2,
-              std::make_unique<LiteralExpr>(LoxObject(3.0))
+              arena.New<LiteralExpr>(LoxObject(3.0))
           )
       )
   );
@@ -67,13 +68,13 @@ void testPrinter() {
 
   // 测试 5: 嵌套一元表达式: -(-5)
   std::cout << "测试 5: 嵌套一元表达式\n";
-  Token minus3(TokenType::MINUS, "-", nullptr, 1);
-  Token minus4(TokenType::MINUS, "-", nullptr, 1);
-  auto nested = std::make_unique<UnaryExpr>(
+  Token minus3(TokenType::MINUS, "-", 1);
+  Token minus4(TokenType::MINUS, "-", 1);
+  auto nested = arena.New<UnaryExpr>(
       minus3,
-      std::make_unique<UnaryExpr>(
+      arena.New<UnaryExpr>(
           minus4,
-          std::make_unique<LiteralExpr>(LoxObject(5.0))
+          arena.New<LiteralExpr>(LoxObject(5.0))
       )
   );
   std::cout << "  表达式: -(-5)\n";
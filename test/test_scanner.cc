@@ -1,9 +1,13 @@
 #include <iostream>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <cassert>
 
 #include "lox_interpreter/core/scanner.h"
+#include "lox_interpreter/core/source.h"
 #include "lox_interpreter/core/token.h"
 #include "lox_interpreter/util/token_type.h"
 
@@ -37,6 +41,53 @@ void testCase(const std::string& name, const std::string& source,
     std::cout << "    ✓ 通过\n";
 }
 
+// 把 text 写入临时文件，用 Source::Load 读回并扫描，token 必须与直接
+// 扫描 text 的结果一致
+void testLoadCase(const std::string& name, const std::string& text,
+                  bool expectMapped) {
+    std::cout << "  测试: " << name << "\n";
+
+    std::string path = (std::filesystem::temp_directory_path() /
+                        "lox_test_source.lox").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+    }
+    Source source;
+    bool loaded = Source::Load(path, &source);
+    std::remove(path.c_str());
+    if (!loaded) {
+        std::cout << "    ❌ 失败: 无法读取临时文件\n";
+        return;
+    }
+    if (source.text() != text || source.mapped() != expectMapped) {
+        std::cout << "    ❌ 失败: 内容或读取方式不符（mmap: "
+                  << source.mapped() << "）\n";
+        return;
+    }
+
+    Scanner fromFile(source.text());
+    Scanner fromString(text);
+    std::vector<Token> actual = fromFile.ScanTokens();
+    std::vector<Token> expected = fromString.ScanTokens();
+    if (actual.size() != expected.size()) {
+        std::cout << "    ❌ 失败: 期望 " << expected.size()
+                  << " 个token，实际得到 " << actual.size() << " 个\n";
+        return;
+    }
+    for (size_t i = 0; i < actual.size(); ++i) {
+        if (actual[i].ToString() != expected[i].ToString() ||
+            actual[i].line() != expected[i].line()) {
+            std::cout << "    ❌ 失败: 位置 " << i << " 期望 "
+                      << expected[i].ToString() << "，实际得到 "
+                      << actual[i].ToString() << "\n";
+            return;
+        }
+    }
+
+    std::cout << "    ✓ 通过\n";
+}
+
 void testScanner() {
     std::cout << "\n1. 单字符Token测试\n";
     testCase("括号", "()", {
@@ -169,6 +220,24 @@ fun greet() {
     std::cout << "  测试: 完整程序\n";
     std::cout << "    ✓ 成功扫描 " << tokens.size() << " 个token\n";
     
+    std::cout << "\n9. 从文件加载源码\n";
+    testLoadCase("小文件一次读入", complexSource, false);
+    std::string largeSource;
+    while (largeSource.size() < 256 * 1024) {
+        largeSource += "var total = 0.5 * (width + height); // area\n";
+    }
+    // 不以换行结尾，最后一个 token 紧贴映射的末尾
+    largeSource += "print \"done\"";
+    testLoadCase("大文件映射", largeSource, true);
+
+    std::cout << "  测试: 文件不存在\n";
+    Source missing;
+    if (Source::Load("/nonexistent/lox_test_source.lox", &missing)) {
+        std::cout << "    ❌ 失败: 应返回 false\n";
+    } else {
+        std::cout << "    ✓ 通过\n";
+    }
+
     std::cout << "\n✅ Scanner 所有测试完成！\n";
 }
 